@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,28 +8,83 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Per-phase frame timers (PROFILE_SCOPE). Compiled out entirely unless defined;
+# on by default for debug builds, add it to DEFINES to profile release builds.
+CONFIG(debug, debug|release): DEFINES += MAZE_PROFILING
+
 SOURCES += \
+    animationclock.cpp \
+    assetarchive.cpp \
+    assetcache.cpp \
+    debugoverlay.cpp \
+    fieldofview.cpp \
+    framebuffersink.cpp \
+    frameprofiler.cpp \
+    gamesimulation.cpp \
     gameview.cpp \
+    gpiochip.cpp \
     gpiocontroller.cpp \
+    gpioedgethread.cpp \
+    headlessrunner.cpp \
+    inputhub.cpp \
+    inputlog.cpp \
+    latencyhistogram.cpp \
+    launchoptions.cpp \
+    levelloader.cpp \
     loadingoverlay.cpp \
     main.cpp \
     mainwindow.cpp \
     mazegenerator.cpp \
+    minimap.cpp \
+    monsteritem.cpp \
     playercontroller.cpp \
     playeritem.cpp \
+    renderbench.cpp \
+    scenebuilder.cpp \
+    softrenderer.cpp \
     startmenu.cpp \
-    textures.cpp
+    textures.cpp \
+    tilelayer.cpp \
+    worldstreamer.cpp
 
 HEADERS += \
+    animationclock.h \
+    assetarchive.h \
+    assetcache.h \
+    debugoverlay.h \
+    fieldofview.h \
+    framebuffersink.h \
+    frameprofiler.h \
+    gamesimulation.h \
     gameview.h \
+    gpiochip.h \
     gpiocontroller.h \
+    gpioedgethread.h \
+    headlessrunner.h \
+    inputbackend.h \
+    inputclock.h \
+    inputevent.h \
+    inputhub.h \
+    inputlog.h \
+    inputstate.h \
+    latencyhistogram.h \
+    launchoptions.h \
+    levelloader.h \
     loadingoverlay.h \
     mainwindow.h \
     mazegenerator.h \
+    minimap.h \
+    monsteritem.h \
+    mpscqueue.h \
     playercontroller.h \
     playeritem.h \
+    renderbench.h \
+    scenebuilder.h \
+    softrenderer.h \
     startmenu.h \
-    textures.h
+    textures.h \
+    tilelayer.h \
+    worldstreamer.h
 
 FORMS += \
     mainwindow.ui
@@ -46,5 +101,12 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 DISTFILES +=
 
+# Optional: `make assets` packs texture/, characters/ and monsters/ next to the
+# executable into assets.pak, which the game then reads instead of the loose files
+pack_assets.target   = assets
+pack_assets.commands = $$OUT_PWD/$$TARGET --pack-assets $$OUT_PWD/assets.pak
+pack_assets.depends  = $(TARGET)
+QMAKE_EXTRA_TARGETS += pack_assets
+
 RESOURCES += \
     resources.qrc
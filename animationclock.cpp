@@ -0,0 +1,50 @@
+#include "animationclock.h"
+#include "frameprofiler.h"
+
+void AnimationClock::play(Animated *a)
+{
+    if (a->m_clockIndex >= 0)
+        return;
+    a->m_clockIndex = m_playing.size();
+    m_playing.append(a);
+}
+
+void AnimationClock::remove(Animated *a)
+{
+    const int i = a->m_clockIndex;
+    if (i < 0)
+        return;
+
+    // Swap with the last entry; order does not matter
+    Animated *last = m_playing.takeLast();
+    if (last != a) {
+        m_playing[i] = last;
+        last->m_clockIndex = i;
+    }
+    a->m_clockIndex = -1;
+}
+
+void AnimationClock::clear()
+{
+    for (Animated *a : m_playing)
+        a->m_clockIndex = -1;
+    m_playing.clear();
+}
+
+void AnimationClock::advance(qint64 nowNs, const QRectF &visible)
+{
+    PROFILE_SCOPE("animate");
+    m_nowNs = nowNs;
+
+    for (int i = 0; i < m_playing.size(); ) {
+        Animated *a = m_playing[i];
+        if (!visible.intersects(a->animationBounds())) {
+            ++i;
+            continue;
+        }
+        if (a->advanceAnimation(nowNs))
+            ++i;
+        else
+            remove(a);   // the last entry moves to i
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+#include <QRectF>
+#include <QVector>
+
+// Something the animation clock advances: typically a sprite item
+class Animated
+{
+public:
+    virtual ~Animated() = default;
+
+    // Show the frame for `nowNs`; false once the picture no longer changes
+    // (single frame, finished), which takes it off the clock
+    virtual bool advanceAnimation(qint64 nowNs) = 0;
+
+    // Scene rect; entities outside the view are not advanced
+    virtual QRectF animationBounds() const = 0;
+
+private:
+    friend class AnimationClock;
+    int m_clockIndex = -1;   // position in the clock's playing list
+};
+
+// One clock for every animated entity, advanced once per frame by the game
+// loop. Only entities with a running animation are on it, so idle ones
+// cost nothing; off-screen ones are skipped and catch up by time when they
+// come back into view. Owners remove entities before deleting them.
+class AnimationClock
+{
+public:
+    void play(Animated *a);      // no-op when already playing
+    void remove(Animated *a);
+    void clear();
+
+    void advance(qint64 nowNs, const QRectF &visible);
+
+    qint64 now() const { return m_nowNs; }
+    int    playing() const { return m_playing.size(); }
+
+private:
+    QVector<Animated*> m_playing;
+    qint64             m_nowNs = 0;
+};
+
+#endif // ANIMATIONCLOCK_H
@@ -0,0 +1,206 @@
+#include "assetarchive.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+const char   kMagic[4]  = { 'M', 'Z', 'P', 'K' };
+const qint64 kHeaderSize = 16;
+const qint64 kAlign      = 16;
+
+} // namespace
+
+AssetArchive::~AssetArchive()
+{
+    close();
+}
+
+bool AssetArchive::open(const QString &path, QString *error)
+{
+    close();
+
+    auto fail = [&](const QString &why) {
+        if (error)
+            *error = why;
+        close();
+        return false;
+    };
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(QString("cannot open %1: %2").arg(path, m_file.errorString()));
+
+    m_size = m_file.size();
+    if (m_size < kHeaderSize)
+        return fail(QString("%1 is not an asset archive").arg(path));
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+        return fail(QString("cannot map %1: %2").arg(path, m_file.errorString()));
+
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data),
+                                                     int(m_size));
+    if (!bytes.startsWith(QByteArray(kMagic, 4)))
+        return fail(QString("%1 is not an asset archive").arg(path));
+
+    QDataStream in(bytes);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.skipRawData(4);
+
+    quint32 version = 0;
+    quint64 indexOffset = 0;
+    in >> version >> indexOffset;
+    if (version != kVersion)
+        return fail(QString("%1: unsupported archive version %2").arg(path).arg(version));
+    if (indexOffset < quint64(kHeaderSize) || indexOffset >= quint64(m_size))
+        return fail(QString("%1: bad index offset").arg(path));
+
+    in.device()->seek(qint64(indexOffset));
+    quint32 count = 0;
+    in >> count;
+    m_index.reserve(int(count));
+
+    for (quint32 i = 0; i < count; ++i) {
+        QByteArray name;
+        Entry e;
+        quint64 offset = 0, length = 0;
+        in >> name >> offset >> length >> e.format;
+
+        if (in.status() != QDataStream::Ok || offset + length > indexOffset)
+            return fail(QString("%1: corrupt index").arg(path));
+
+        e.offset = qint64(offset);
+        e.length = qint64(length);
+        m_index.insert(QString::fromUtf8(name), e);
+    }
+    return true;
+}
+
+void AssetArchive::close()
+{
+    m_index.clear();
+    if (m_data)
+        m_file.unmap(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    m_file.close();
+}
+
+QByteArray AssetArchive::data(const QString &name) const
+{
+    auto it = m_index.constFind(name);
+    if (it == m_index.constEnd())
+        return QByteArray();
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(m_data + it->offset),
+                                   int(it->length));
+}
+
+QImage AssetArchive::decode(const QString &name) const
+{
+    auto it = m_index.constFind(name);
+    if (it == m_index.constEnd())
+        return QImage();
+
+    QImage img;
+    img.loadFromData(m_data + it->offset, int(it->length), it->format.constData());
+    return img;
+}
+
+QSize AssetArchive::imageSize(const QString &name) const
+{
+    QByteArray bytes = data(name);
+    if (bytes.isEmpty())
+        return QSize();
+
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    return QImageReader(&buffer, m_index.value(name).format).size();
+}
+
+QStringList AssetArchive::list(const QString &folder) const
+{
+    const QString prefix = folder.endsWith('/') ? folder : folder + '/';
+
+    QStringList names;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (it.key().startsWith(prefix) && it.key().indexOf('/', prefix.size()) < 0)
+            names.append(it.key());
+    }
+
+    std::sort(names.begin(), names.end(), [](const QString &a, const QString &b) {
+        return a.compare(b, Qt::CaseInsensitive) < 0;
+    });
+    return names;
+}
+
+bool AssetArchive::pack(const QString &rootDir, const QStringList &folders,
+                        const QString &archivePath, int *fileCount, QString *error)
+{
+    const QDir root(rootDir);
+
+    QStringList names;
+    for (const QString &folder : folders) {
+        QDirIterator it(root.filePath(folder), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            names.append(root.relativeFilePath(it.next()));
+    }
+    std::sort(names.begin(), names.end());
+
+    QSaveFile out(archivePath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = QString("cannot write %1: %2").arg(archivePath, out.errorString());
+        return false;
+    }
+
+    QDataStream stream(&out);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(kMagic, 4);
+    stream << kVersion << quint64(0);   // index offset, patched below
+
+    struct Packed { QByteArray name; quint64 offset, length; QByteArray format; };
+    QVector<Packed> index;
+
+    for (const QString &name : names) {
+        QFile file(root.filePath(name));
+        if (!file.open(QIODevice::ReadOnly)) {
+            if (error)
+                *error = QString("cannot read %1: %2").arg(file.fileName(), file.errorString());
+            return false;
+        }
+        const QByteArray contents = file.readAll();
+
+        const qint64 pad = (kAlign - out.pos() % kAlign) % kAlign;
+        stream.writeRawData(QByteArray(int(pad), '\0').constData(), int(pad));
+
+        index.append({ name.toUtf8(), quint64(out.pos()), quint64(contents.size()),
+                       QFileInfo(name).suffix().toLower().toLatin1() });
+        stream.writeRawData(contents.constData(), contents.size());
+    }
+
+    const quint64 indexOffset = quint64(out.pos());
+    stream << quint32(index.size());
+    for (const Packed &p : index)
+        stream << p.name << p.offset << p.length << p.format;
+
+    out.seek(8);
+    stream << indexOffset;
+
+    if (stream.status() != QDataStream::Ok || !out.commit()) {
+        if (error)
+            *error = QString("cannot write %1: %2").arg(archivePath, out.errorString());
+        return false;
+    }
+    if (fileCount)
+        *fileCount = index.size();
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+// Read-only pack of asset files, memory-mapped once. Files are looked up
+// by their path relative to the asset root ("texture/walls/lair0.png")
+// and decoded straight from the mapping.
+//
+// Layout (little endian):
+//   header  "MZPK", quint32 version, quint64 index offset
+//   data    file contents, each aligned to 16 bytes
+//   index   quint32 count, then per file: name (UTF-8), quint64 offset,
+//           quint64 length, format (e.g. "png"); names as QByteArray
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive &) = delete;
+    AssetArchive &operator=(const AssetArchive &) = delete;
+
+    bool open(const QString &path, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Safe from any thread while the archive stays open
+    bool       contains(const QString &name) const { return m_index.contains(name); }
+    QByteArray data(const QString &name) const;      // no copy, backed by the mapping
+    QImage     decode(const QString &name) const;
+    QSize      imageSize(const QString &name) const; // header only
+
+    // Files directly inside `folder`, sorted by name (case-insensitive)
+    QStringList list(const QString &folder) const;
+
+    int count() const { return m_index.size(); }
+
+    // Pack every file below `folders` of `rootDir` into `archivePath`
+    static bool pack(const QString &rootDir, const QStringList &folders,
+                     const QString &archivePath, int *fileCount = nullptr,
+                     QString *error = nullptr);
+
+    static constexpr quint32 kVersion = 1;
+
+private:
+    struct Entry {
+        qint64     offset = 0;
+        qint64     length = 0;
+        QByteArray format;
+    };
+
+    QFile               m_file;
+    uchar              *m_data = nullptr;
+    qint64              m_size = 0;
+    QHash<QString, Entry> m_index;
+};
+
+#endif // ASSETARCHIVE_H
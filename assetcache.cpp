@@ -0,0 +1,256 @@
+#include "assetcache.h"
+#include "frameprofiler.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QReadLocker>
+#include <QSet>
+#include <QWriteLocker>
+#include <QtConcurrent>
+
+namespace {
+
+QImage decode(const AssetCache &cache, const AssetRequest &req)
+{
+    QImage img = cache.readImage(req.path);
+    if (img.isNull())
+        return img;
+
+    if (req.scale > 0.0 && req.scale != 1.0) {
+        return img.scaled(int(img.width() * req.scale), int(img.height() * req.scale),
+                          req.mode, Qt::SmoothTransformation);
+    }
+    if (req.size.isValid() && req.size != img.size())
+        return img.scaled(req.size, req.mode, Qt::SmoothTransformation);
+    return img;
+}
+
+} // namespace
+
+// Map functor; caches each image as it finishes and stops decoding once
+// the batch is cancelled
+struct AssetCache::Decoder
+{
+    using result_type = QImage;
+
+    AssetCache              *cache;
+    const std::atomic<bool> *cancel;
+
+    QImage operator()(const AssetRequest &req) const
+    {
+        const bool skip = cancel && *cancel;
+        QImage img = skip ? QImage() : decode(*cache, req);
+        cache->finish(req.key(), img, !skip);
+        return img;
+    }
+};
+
+QString AssetRequest::key() const
+{
+    return QString("%1|%2x%3|%4|%5")
+        .arg(path)
+        .arg(size.width())
+        .arg(size.height())
+        .arg(int(mode))
+        .arg(scale);
+}
+
+AssetCache &AssetCache::instance()
+{
+    static AssetCache cache;
+    return cache;
+}
+
+bool AssetCache::mountArchive(const QString &archivePath, const QString &assetRoot,
+                              QString *error)
+{
+    if (!m_archive.open(archivePath, error))
+        return false;
+
+    m_archiveRoot = QDir::cleanPath(assetRoot) + '/';
+    return true;
+}
+
+QString AssetCache::archiveName(const QString &path) const
+{
+    if (!m_archive.isOpen() || !path.startsWith(m_archiveRoot))
+        return QString();
+
+    const QString name = QDir::cleanPath(path.mid(m_archiveRoot.size()));
+    return m_archive.contains(name) ? name : QString();
+}
+
+QImage AssetCache::readImage(const QString &path) const
+{
+    const QString name = archiveName(path);
+    return name.isEmpty() ? QImage(path) : m_archive.decode(name);
+}
+
+QSize AssetCache::imageSize(const QString &path) const
+{
+    const QString name = archiveName(path);
+    return name.isEmpty() ? QImageReader(path).size() : m_archive.imageSize(name);
+}
+
+QStringList AssetCache::imageFiles(const QString &folder) const
+{
+    QStringList paths;
+
+    if (m_archive.isOpen() && folder.startsWith(m_archiveRoot)) {
+        const QString dir = QDir::cleanPath(folder.mid(m_archiveRoot.size()));
+        for (const QString &name : m_archive.list(dir)) {
+            if (name.endsWith(".png", Qt::CaseInsensitive))
+                paths.append(m_archiveRoot + name);
+        }
+        if (!paths.isEmpty())
+            return paths;
+    }
+
+    QDir dir(folder);
+    dir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
+    dir.setNameFilters(QStringList() << "*.png" << "*.PNG");
+    dir.setSorting(QDir::Name | QDir::IgnoreCase);
+    for (const QString &file : dir.entryList())
+        paths.append(folder + "/" + file);
+    return paths;
+}
+
+QIODevice *AssetCache::openFile(const QString &path) const
+{
+    const QString name = archiveName(path);
+    QIODevice *dev = nullptr;
+    if (name.isEmpty()) {
+        dev = new QFile(path);
+    } else {
+        auto *buffer = new QBuffer;
+        buffer->setData(m_archive.data(name));   // still backed by the mapping
+        dev = buffer;
+    }
+
+    if (!dev->open(QIODevice::ReadOnly)) {
+        delete dev;
+        return nullptr;
+    }
+    return dev;
+}
+
+QImage AssetCache::image(const AssetRequest &request)
+{
+    const QString key = request.key();
+    QFuture<QImage> inFlight;
+    bool pending = false;
+    {
+        QReadLocker lock(&m_lock);
+        auto it = m_images.constFind(key);
+        if (it != m_images.constEnd())
+            return *it;
+        auto p = m_pending.constFind(key);
+        if (p != m_pending.constEnd()) {
+            inFlight = *p;
+            pending  = true;
+        }
+    }
+
+    // A batch is decoding it; wait rather than decode twice
+    if (pending) {
+        inFlight.waitForFinished();
+        QReadLocker lock(&m_lock);
+        auto it = m_images.constFind(key);
+        if (it != m_images.constEnd())
+            return *it;
+    }
+
+    // Decode outside the lock; a racing thread may decode the same file,
+    // the first one stored wins
+    QImage img = decode(*this, request);
+
+    QWriteLocker lock(&m_lock);
+    auto it = m_images.constFind(key);
+    if (it != m_images.constEnd())
+        return *it;
+    m_images.insert(key, img);
+    return img;
+}
+
+void AssetCache::load(const QVector<AssetRequest> &requests,
+                      const std::atomic<bool> *cancel)
+{
+    PROFILE_SCOPE("assetDecode");
+
+    QVector<AssetRequest>    misses;
+    QVector<AssetRequest>    elsewhere;   // being decoded by another batch
+    QVector<QFuture<QImage>> inFlight;
+    QFuture<QImage>          decoded;
+    {
+        QSet<QString> seen;
+        QWriteLocker lock(&m_lock);
+        for (const AssetRequest &req : requests) {
+            const QString key = req.key();
+            if (m_images.contains(key) || seen.contains(key))
+                continue;
+            seen.insert(key);
+
+            auto it = m_pending.constFind(key);
+            if (it != m_pending.constEnd()) {
+                elsewhere.append(req);
+                inFlight.append(*it);   // finished ones return at once
+                continue;
+            }
+            misses.append(req);
+        }
+
+        // Registered before the lock is released, so a batch started
+        // meanwhile waits for these keys instead of decoding them too
+        if (!misses.isEmpty()) {
+            decoded = QtConcurrent::mapped(misses, Decoder{this, cancel});
+            for (const AssetRequest &req : misses)
+                m_pending.insert(req.key(), decoded);
+        }
+    }
+
+    if (!misses.isEmpty())
+        decoded.waitForFinished();
+    for (QFuture<QImage> &f : inFlight)
+        f.waitForFinished();
+
+    // Whatever a cancelled batch skipped is decoded here
+    if (cancel && *cancel)
+        return;
+    for (const AssetRequest &req : std::as_const(elsewhere))
+        image(req);
+}
+
+void AssetCache::finish(const QString &key, const QImage &image, bool store)
+{
+    QWriteLocker lock(&m_lock);
+    m_pending.remove(key);
+    if (store && !m_images.contains(key))
+        m_images.insert(key, image);
+}
+
+QFuture<void> AssetCache::preload(std::function<QVector<AssetRequest>()> requests)
+{
+    return QtConcurrent::run([this, requests] { load(requests()); });
+}
+
+QPixmap AssetCache::pixmap(const QImage &image)
+{
+    if (image.isNull())
+        return QPixmap();
+
+    auto it = m_pixmaps.constFind(image.cacheKey());
+    if (it != m_pixmaps.constEnd())
+        return *it;
+
+    QPixmap pix = QPixmap::fromImage(image);
+    m_pixmaps.insert(image.cacheKey(), pix);
+    return pix;
+}
+
+int AssetCache::imageCount() const
+{
+    QReadLocker lock(&m_lock);
+    return m_images.size();
+}
@@ -0,0 +1,95 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <QFuture>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QReadWriteLock>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+#include "assetarchive.h"
+
+class QIODevice;
+
+// One decoded image: a file plus how to scale it
+struct AssetRequest
+{
+    QString             path;
+    QSize               size;                        // invalid keeps the file size
+    Qt::AspectRatioMode mode  = Qt::IgnoreAspectRatio;
+    qreal               scale = 0.0;                 // > 0 scales by factor instead
+
+    QString key() const;
+};
+
+// Process-wide cache of decoded, scaled images. Decoding runs on any
+// thread; misses of a batch are decoded in parallel on the global thread
+// pool. Pixmaps are converted once, on the GUI thread, and shared by every
+// item that shows the same image.
+//
+// Files come from a mounted AssetArchive when it has them and from the
+// loose asset folders otherwise.
+class AssetCache
+{
+public:
+    static AssetCache &instance();
+
+    // Serve files below `assetRoot` from a packed archive. Call once at
+    // startup, before anything is loaded.
+    bool mountArchive(const QString &archivePath, const QString &assetRoot,
+                      QString *error = nullptr);
+    bool hasArchive() const { return m_archive.isOpen(); }
+
+    // Uncached file access, archive first; any thread
+    QImage      readImage(const QString &path) const;
+    QSize       imageSize(const QString &path) const;     // header only
+    QStringList imageFiles(const QString &folder) const;  // *.png, sorted by name
+    QIODevice  *openFile(const QString &path) const;      // caller owns; null if missing
+
+    // Any thread; decodes on a miss. Missing files give a null image.
+    QImage image(const AssetRequest &request);
+
+    // Any thread; decodes every miss in parallel and blocks until done.
+    // Images another batch is already decoding are waited for rather than
+    // decoded twice. Each image is cached as soon as it is decoded; nothing
+    // is cached for requests skipped after `cancel` is set.
+    void load(const QVector<AssetRequest> &requests,
+              const std::atomic<bool> *cancel = nullptr);
+
+    // Builds the requests and runs load() on the thread pool; for warming
+    // the cache ahead of use. Building them lists folders and reads image
+    // headers, so that happens on the pool too.
+    QFuture<void> preload(std::function<QVector<AssetRequest>()> requests);
+
+    // GUI thread: pixmap of an image returned by this cache
+    QPixmap pixmap(const QImage &image);
+
+    int imageCount() const;
+
+private:
+    AssetCache() = default;
+
+    struct Decoder;
+
+    // Worker side of load(): caches a decoded image and clears its key
+    void finish(const QString &key, const QImage &image, bool store);
+
+    // Name inside the archive, or empty when the file is not packed
+    QString archiveName(const QString &path) const;
+
+    AssetArchive m_archive;
+    QString      m_archiveRoot;   // with trailing slash
+
+    mutable QReadWriteLock  m_lock;
+    QHash<QString, QImage>  m_images;
+    QHash<QString, QFuture<QImage>> m_pending;   // key -> batch decoding it
+    QHash<qint64, QPixmap>  m_pixmaps;   // by QImage::cacheKey(), GUI only
+};
+
+#endif // ASSETCACHE_H
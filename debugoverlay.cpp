@@ -0,0 +1,106 @@
+#include "debugoverlay.h"
+#include "frameprofiler.h"
+#include "latencyhistogram.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+DebugOverlay::DebugOverlay(QWidget *parent)
+    : QWidget(parent)
+{
+    // Purely informational: never steal input from the game view
+    setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    setFocusPolicy(Qt::NoFocus);
+
+    setGeometry(4, 4, 240, 172);
+    hide(); // hidden by default
+}
+
+void DebugOverlay::toggle()
+{
+    if (isVisible()) {
+        hide();
+    } else {
+        raise();
+        show();
+    }
+}
+
+void DebugOverlay::setInputLatency(const LatencyHistogram *histogram)
+{
+    m_latency = histogram;
+}
+
+void DebugOverlay::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    const FrameProfiler &prof = FrameProfiler::instance();
+
+    QPainter p(this);
+    p.fillRect(rect(), QColor(0, 0, 0, 170));
+
+    QFont f = p.font();
+    f.setStyleHint(QFont::Monospace);
+    f.setFamily("monospace");
+    f.setPixelSize(10);
+    p.setFont(f);
+    p.setPen(Qt::white);
+
+    // ---- Percentiles ----
+    const float p50 = prof.frameTimePercentile(0.50);
+    const float p95 = prof.frameTimePercentile(0.95);
+    const float p99 = prof.frameTimePercentile(0.99);
+    p.drawText(4, 12, QString("frame p50 %1  p95 %2  p99 %3 ms")
+                          .arg(p50, 0, 'f', 1)
+                          .arg(p95, 0, 'f', 1)
+                          .arg(p99, 0, 'f', 1));
+
+    if (m_latency && m_latency->count() > 0) {
+        p.drawText(4, 24, QString("input p50 %1  p95 %2  p99 %3 ms")
+                              .arg(m_latency->percentileMs(0.50), 0, 'f', 1)
+                              .arg(m_latency->percentileMs(0.95), 0, 'f', 1)
+                              .arg(m_latency->percentileMs(0.99), 0, 'f', 1));
+    } else {
+        p.drawText(4, 24, "input: no samples yet");
+    }
+
+    // ---- Rolling frame-time graph (0..50 ms) ----
+    const QRect graph(4, 30, width() - 8, 44);
+    const qreal maxMs = 50.0;
+
+    p.setPen(QColor(255, 255, 255, 60));
+    p.drawRect(graph.adjusted(0, 0, -1, -1));
+
+    // 60 FPS budget line
+    int budgetY = graph.bottom() - int(graph.height() * (16.7 / maxMs));
+    p.setPen(QColor(255, 255, 0, 140));
+    p.drawLine(graph.left(), budgetY, graph.right(), budgetY);
+
+    const QVector<float> times = prof.frameTimesMs();
+    const int n = times.size();
+    for (int i = 0; i < n && i < graph.width(); ++i) {
+        float ms = times[n - 1 - i];
+        int h = int(graph.height() * qMin(1.0, ms / maxMs));
+        int x = graph.right() - i;
+        p.setPen(ms > 16.7f ? QColor(255, 80, 80) : QColor(80, 220, 80));
+        p.drawLine(x, graph.bottom(), x, graph.bottom() - h);
+    }
+
+    // ---- Per-phase averages ----
+    p.setPen(Qt::white);
+    int y = graph.bottom() + 12;
+    const QVector<FrameProfiler::PhaseStat> phases = prof.phaseStats();
+    if (phases.isEmpty()) {
+        p.drawText(4, y, "phases: build with MAZE_PROFILING");
+        return;
+    }
+    for (const FrameProfiler::PhaseStat &s : phases) {
+        if (y > height() - 2)
+            break;
+        p.drawText(4, y, QString("%1  %2 ms")
+                             .arg(QString::fromLatin1(s.name), -18)
+                             .arg(s.avgMs, 0, 'f', 2));
+        y += 11;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef DEBUGOVERLAY_H
+#define DEBUGOVERLAY_H
+
+#include <QWidget>
+
+class LatencyHistogram;
+
+// Semi-transparent panel over the game view showing a rolling frame-time
+// graph, frame-time and input-latency percentiles and the per-phase
+// timings of FrameProfiler.
+class DebugOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DebugOverlay(QWidget *parent = nullptr);
+
+    void toggle();
+
+    // Input-to-paint latency shown under the frame times; may be null
+    void setInputLatency(const LatencyHistogram *histogram);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    const LatencyHistogram *m_latency = nullptr;
+};
+
+#endif // DEBUGOVERLAY_H
@@ -0,0 +1,126 @@
+#include "fieldofview.h"
+#include "frameprofiler.h"
+
+#include <utility>
+
+void FieldOfView::setLevel(const std::vector<std::vector<int>> &grid)
+{
+    m_rows = int(grid.size());
+    m_cols = m_rows ? int(grid[0].size()) : 0;
+
+    m_opaque  = QBitArray(m_rows * m_cols);
+    m_visible = QBitArray(m_rows * m_cols);
+    m_lit.clear();
+    for (int r = 0; r < m_rows; ++r) {
+        for (int c = 0; c < m_cols; ++c) {
+            if (grid[r][c] != 0)
+                m_opaque.setBit(r * m_cols + c);
+        }
+    }
+
+    m_origin = QPoint(-1, -1);
+    m_dirty  = true;
+}
+
+void FieldOfView::setOpaque(int row, int col, bool opaque)
+{
+    if (row < 0 || col < 0 || row >= m_rows || col >= m_cols)
+        return;
+    m_opaque.setBit(row * m_cols + col, opaque);
+    m_dirty = true;
+}
+
+QRect FieldOfView::bounds() const
+{
+    if (m_origin.x() < 0)
+        return QRect();
+    return QRect(m_origin - QPoint(m_radius, m_radius),
+                 QSize(2 * m_radius + 1, 2 * m_radius + 1)) & QRect(0, 0, m_cols, m_rows);
+}
+
+bool FieldOfView::update(const QPoint &cell)
+{
+    if (cell == m_origin && !m_dirty)
+        return false;
+
+    PROFILE_SCOPE("fov");
+
+    for (int i : std::as_const(m_lit))
+        m_visible.clearBit(i);
+    m_lit.clear();
+
+    m_origin = cell;
+    m_dirty  = false;
+
+    light(cell.y(), cell.x());
+
+    // Octant transforms: (dx, dy) in octant space -> (col, row) offsets
+    static const int xx[8] = { 1,  0,  0, -1, -1,  0,  0,  1 };
+    static const int xy[8] = { 0,  1, -1,  0,  0, -1,  1,  0 };
+    static const int yx[8] = { 0,  1,  1,  0,  0, -1, -1,  0 };
+    static const int yy[8] = { 1,  0,  0,  1, -1,  0,  0, -1 };
+    for (int o = 0; o < 8; ++o)
+        castLight(1, 1.0f, 0.0f, xx[o], xy[o], yx[o], yy[o]);
+    return true;
+}
+
+void FieldOfView::light(int row, int col)
+{
+    if (row < 0 || col < 0 || row >= m_rows || col >= m_cols)
+        return;
+
+    const int i = row * m_cols + col;
+    if (!m_visible.testBit(i)) {
+        m_visible.setBit(i);
+        m_lit.append(i);
+    }
+}
+
+// Scans one octant row by row outward from the origin, between the slopes
+// `start` and `end`; an opaque cell splits the range and the part beyond
+// it continues in a recursive scan
+void FieldOfView::castLight(int distance, float start, float end,
+                            int xx, int xy, int yx, int yy)
+{
+    if (start < end)
+        return;
+
+    const int radius2 = m_radius * m_radius;
+    float nextStart = start;
+
+    for (int j = distance; j <= m_radius; ++j) {
+        bool blocked = false;
+        const int dy = -j;
+
+        for (int dx = -j; dx <= 0; ++dx) {
+            const int col = m_origin.x() + dx * xx + dy * xy;
+            const int row = m_origin.y() + dx * yx + dy * yy;
+            const float leftSlope  = (dx - 0.5f) / (dy + 0.5f);
+            const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+
+            if (start < rightSlope)
+                continue;
+            if (end > leftSlope)
+                break;
+
+            if (dx * dx + dy * dy <= radius2)
+                light(row, col);
+
+            if (blocked) {
+                if (isOpaque(row, col)) {
+                    nextStart = rightSlope;
+                } else {
+                    blocked = false;
+                    start = nextStart;
+                }
+            } else if (isOpaque(row, col) && j < m_radius) {
+                blocked = true;
+                castLight(j + 1, start, leftSlope, xx, xy, yx, yy);
+                nextStart = rightSlope;
+            }
+        }
+
+        if (blocked)
+            break;
+    }
+}
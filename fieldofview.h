@@ -0,0 +1,60 @@
+#ifndef FIELDOFVIEW_H
+#define FIELDOFVIEW_H
+
+#include <QBitArray>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+#include <vector>
+
+// Line of sight on the maze grid by recursive shadowcasting over the eight
+// octants around one cell. Walls and closed doors block sight and are seen
+// themselves. Recomputed only when the origin cell changes or a cell's
+// opacity does, and then only the cells lit last time are cleared, so the
+// cost depends on the radius, not on the size of the maze. QtCore only.
+class FieldOfView
+{
+public:
+    // Cells with 1 (wall) or 2 (door) block sight
+    void setLevel(const std::vector<std::vector<int>> &grid);
+    void setRadius(int cells) { m_radius = cells; m_dirty = true; }
+    int  radius() const { return m_radius; }
+
+    // E.g. a door opening; takes effect on the next update()
+    void setOpaque(int row, int col, bool opaque);
+
+    // Recomputes from `cell` when anything changed; true if it did
+    bool update(const QPoint &cell);
+
+    bool isVisible(int row, int col) const
+    {
+        return row >= 0 && col >= 0 && row < m_rows && col < m_cols
+               && m_visible.testBit(row * m_cols + col);
+    }
+
+    // One bit per cell, row-major
+    const QBitArray &visible() const { return m_visible; }
+
+    // Cells that can be visible from the current origin
+    QRect bounds() const;
+
+private:
+    bool isOpaque(int row, int col) const
+    {
+        return row < 0 || col < 0 || row >= m_rows || col >= m_cols
+               || m_opaque.testBit(row * m_cols + col);
+    }
+    void light(int row, int col);
+    void castLight(int distance, float start, float end, int xx, int xy, int yx, int yy);
+
+    int       m_rows = 0;
+    int       m_cols = 0;
+    int       m_radius = 8;
+    QBitArray m_opaque;
+    QBitArray m_visible;
+    QVector<int> m_lit;             // indices set in m_visible
+    QPoint    m_origin { -1, -1 };
+    bool      m_dirty = true;
+};
+
+#endif // FIELDOFVIEW_H
@@ -0,0 +1,95 @@
+#include "framebuffersink.h"
+#include "frameprofiler.h"
+
+#include <QFile>
+
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fb.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FramebufferSink::~FramebufferSink()
+{
+    close();
+}
+
+bool FramebufferSink::open(const QString &path, const QSize &size,
+                           QImage::Format format, QString *error)
+{
+    close();
+
+    auto fail = [&](const QString &message) {
+        if (error)
+            *error = message;
+        close();
+        return false;
+    };
+
+    m_fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+        return fail(QString("Cannot open %1").arg(path));
+
+    struct stat st;
+    if (::fstat(m_fd, &st) < 0)
+        return fail(QString("Cannot stat %1").arg(path));
+
+    if (S_ISCHR(st.st_mode)) {
+        fb_var_screeninfo var;
+        fb_fix_screeninfo fix;
+        if (::ioctl(m_fd, FBIOGET_VSCREENINFO, &var) < 0 ||
+            ::ioctl(m_fd, FBIOGET_FSCREENINFO, &fix) < 0)
+            return fail(QString("%1 is not a framebuffer device").arg(path));
+
+        if (var.bits_per_pixel == 16)
+            m_format = QImage::Format_RGB16;
+        else if (var.bits_per_pixel == 32)
+            m_format = QImage::Format_RGB32;
+        else
+            return fail(QString("Unsupported framebuffer depth %1 bpp")
+                            .arg(var.bits_per_pixel));
+
+        m_size    = QSize(int(var.xres), int(var.yres));
+        m_stride  = int(fix.line_length);
+        m_mapSize = fix.smem_len;
+    } else {
+        m_format  = format;
+        m_size    = size;
+        m_stride  = size.width() * (format == QImage::Format_RGB16 ? 2 : 4);
+        m_mapSize = size_t(m_stride) * size.height();
+        if (::ftruncate(m_fd, off_t(m_mapSize)) < 0)
+            return fail(QString("Cannot resize %1").arg(path));
+    }
+
+    void *map = ::mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED)
+        return fail(QString("Cannot map %1").arg(path));
+    m_map = static_cast<uchar *>(map);
+    return true;
+}
+
+void FramebufferSink::close()
+{
+    if (m_map)
+        ::munmap(m_map, m_mapSize);
+    if (m_fd >= 0)
+        ::close(m_fd);
+    m_map     = nullptr;
+    m_mapSize = 0;
+    m_fd      = -1;
+}
+
+void FramebufferSink::present(const QImage &frame)
+{
+    if (!m_map || frame.format() != m_format)
+        return;
+
+    PROFILE_SCOPE("present");
+
+    const int rows = qMin(frame.height(), m_size.height());
+    const size_t bytes = size_t(qMin(frame.width(), m_size.width())) * (frame.depth() / 8);
+    for (int y = 0; y < rows; ++y)
+        std::memcpy(m_map + size_t(y) * m_stride, frame.constScanLine(y), bytes);
+}
@@ -0,0 +1,38 @@
+#ifndef FRAMEBUFFERSINK_H
+#define FRAMEBUFFERSINK_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// Output of SoftRenderer frames to a Linux framebuffer device (/dev/fbN)
+// or, for testing without one, to a plain file holding a single raw frame.
+// Either is memory-mapped once; presenting a frame is a memcpy per row.
+class FramebufferSink
+{
+public:
+    FramebufferSink() = default;
+    ~FramebufferSink();
+
+    // A device dictates size and pixel format (16 or 32 bpp); a plain file
+    // is created with `size` and `format` (Format_RGB16 or Format_RGB32)
+    bool open(const QString &path, const QSize &size, QImage::Format format,
+              QString *error = nullptr);
+    void close();
+
+    bool isOpen() const { return m_map != nullptr; }
+    QImage::Format format() const { return m_format; }
+
+    // Copies the top-left part of `frame` that fits; formats must match
+    void present(const QImage &frame);
+
+private:
+    int            m_fd = -1;
+    uchar         *m_map = nullptr;
+    size_t         m_mapSize = 0;
+    QSize          m_size;
+    int            m_stride = 0;   // bytes per line
+    QImage::Format m_format = QImage::Format_Invalid;
+};
+
+#endif // FRAMEBUFFERSINK_H
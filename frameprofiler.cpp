@@ -0,0 +1,121 @@
+#include "frameprofiler.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+
+FrameProfiler &FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::FrameProfiler()
+    : m_frameMs(kFrameWindow, 0.0f)
+{
+    m_clock.start();
+}
+
+void FrameProfiler::markFrame()
+{
+    const qint64 now = nowNs();
+    if (m_lastFrameNs >= 0) {
+        m_frameMs[m_frameHead] = float((now - m_lastFrameNs) / 1e6);
+        m_frameHead = (m_frameHead + 1) % kFrameWindow;
+        m_frameCount = qMin(m_frameCount + 1, int(kFrameWindow));
+    }
+    m_lastFrameNs = now;
+}
+
+void FrameProfiler::addSample(const char *name, qint64 startNs, qint64 durationNs)
+{
+    QMutexLocker lock(&m_mutex);
+
+    // Allocate the trace buffer lazily so release builds never pay for it
+    if (m_events.isEmpty())
+        m_events.resize(kMaxEvents);
+
+    Event &e = m_events[m_eventHead];
+    e.name       = name;
+    e.startNs    = startNs;
+    e.durationNs = durationNs;
+    e.thread     = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    m_eventHead  = (m_eventHead + 1) % kMaxEvents;
+    m_eventCount = qMin(m_eventCount + 1, int(kMaxEvents));
+
+    // Names are literals, so pointer identity is enough for lookup
+    const double ms = durationNs / 1e6;
+    for (PhaseStat &s : m_phases) {
+        if (s.name == name) {
+            s.avgMs  = s.avgMs * 0.95 + ms * 0.05;
+            s.lastMs = ms;
+            return;
+        }
+    }
+    m_phases.append({ name, ms, ms });
+}
+
+QVector<float> FrameProfiler::frameTimesMs() const
+{
+    QVector<float> out;
+    out.reserve(m_frameCount);
+
+    int start = (m_frameHead - m_frameCount + kFrameWindow) % kFrameWindow;
+    for (int i = 0; i < m_frameCount; ++i)
+        out.append(m_frameMs[(start + i) % kFrameWindow]);
+    return out;
+}
+
+float FrameProfiler::frameTimePercentile(double p) const
+{
+    QVector<float> times = frameTimesMs();
+    if (times.isEmpty())
+        return 0.0f;
+
+    int idx = qBound(0, int(p * (times.size() - 1) + 0.5), int(times.size()) - 1);
+    std::nth_element(times.begin(), times.begin() + idx, times.end());
+    return times[idx];
+}
+
+QVector<FrameProfiler::PhaseStat> FrameProfiler::phaseStats() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_phases;
+}
+
+bool FrameProfiler::writeChromeTrace(const QString &path) const
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QMutexLocker lock(&m_mutex);
+
+    // Map raw thread handles to small ids so the viewer shows tidy lanes
+    QVector<quintptr> threads;
+
+    QTextStream out(&f);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    int start = (m_eventHead - m_eventCount + kMaxEvents) % kMaxEvents;
+    for (int i = 0; i < m_eventCount; ++i) {
+        const Event &e = m_events[(start + i) % kMaxEvents];
+
+        int tid = threads.indexOf(e.thread);
+        if (tid < 0) {
+            tid = threads.size();
+            threads.append(e.thread);
+        }
+
+        out << (i ? ",\n" : "")
+            << "{\"name\":\"" << e.name << "\",\"cat\":\"maze\",\"ph\":\"X\""
+            << ",\"ts\":" << QString::number(e.startNs / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(e.durationNs / 1000.0, 'f', 3)
+            << ",\"pid\":1,\"tid\":" << tid << "}";
+    }
+
+    out << "\n]}\n";
+    return out.status() == QTextStream::Ok;
+}
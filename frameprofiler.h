@@ -0,0 +1,99 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// Collects per-phase timings (scoped timers) and a rolling window of frame
+// times. Phases are only recorded when built with MAZE_PROFILING; frame
+// times are always kept since that is a single sample per frame.
+class FrameProfiler
+{
+public:
+    struct PhaseStat {
+        const char *name;
+        double      avgMs;    // exponential moving average
+        double      lastMs;
+    };
+
+    static FrameProfiler &instance();
+
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+    // Called once per game-loop frame
+    void markFrame();
+
+    // Record one finished phase; `name` must be a string literal
+    void addSample(const char *name, qint64 startNs, qint64 durationNs);
+
+    // Rolling frame times, oldest first
+    QVector<float> frameTimesMs() const;
+    float frameTimePercentile(double p) const;   // p in [0, 1]
+    QVector<PhaseStat> phaseStats() const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto)
+    bool writeChromeTrace(const QString &path) const;
+
+    static constexpr int kFrameWindow = 240;     // ~4 s at 60 FPS
+    static constexpr int kMaxEvents   = 65536;   // trace ring buffer
+
+private:
+    FrameProfiler();
+
+    struct Event {
+        const char *name;
+        qint64      startNs;
+        qint64      durationNs;
+        quintptr    thread;
+    };
+
+    QElapsedTimer m_clock;
+
+    qint64         m_lastFrameNs = -1;
+    QVector<float> m_frameMs;        // ring buffer
+    int            m_frameHead  = 0;
+    int            m_frameCount = 0;
+
+    mutable QMutex     m_mutex;      // phases may be recorded from worker threads
+    QVector<Event>     m_events;     // ring buffer
+    int                m_eventHead  = 0;
+    int                m_eventCount = 0;
+    QVector<PhaseStat> m_phases;
+};
+
+// RAII timer for one phase; use through PROFILE_SCOPE
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char *name)
+        : m_name(name),
+        m_startNs(FrameProfiler::instance().nowNs())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        FrameProfiler &p = FrameProfiler::instance();
+        p.addSample(m_name, m_startNs, p.nowNs() - m_startNs);
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const char *m_name;
+    qint64      m_startNs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef MAZE_PROFILING
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // FRAMEPROFILER_H
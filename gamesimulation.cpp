@@ -0,0 +1,501 @@
+#include "gamesimulation.h"
+#include "frameprofiler.h"
+
+#include <QLineF>
+#include <cmath>
+
+GameSimulation::GameSimulation(int cellSize)
+    : m_cellSize(cellSize)
+{
+    setSeed(QRandomGenerator::global()->generate());
+}
+
+void GameSimulation::setSeed(quint32 seed)
+{
+    m_seed = seed;
+    m_sessionRng.seed(seed);
+    m_rng.seed(seed);
+}
+
+quint32 GameSimulation::nextLevelSeed()
+{
+    return m_sessionRng.generate();
+}
+
+void GameSimulation::loadLevel(const MazeGenerator::MazeData &maze)
+{
+    m_grid       = maze.grid;
+    m_gridOrigin = QPoint(0, 0);
+    m_blockCells = maze.scale;
+
+    const int gridRows = rows();
+    const int gridCols = cols();
+
+    // Monster randomness depends only on the level, not on earlier levels
+    m_rng.seed(maze.seed ^ 0x9e3779b9u);
+
+    // ---- Reset per-level state ----
+    m_monsters.clear();
+    m_nextMonsterId = 0;
+    m_events.clear();
+    m_walkableCells.clear();
+    m_playerHp      = m_playerMaxHp;
+    m_slowTicksLeft = 0;
+    m_slowFactor    = 1.0;
+    m_facing        = Front;
+    m_playerMoving  = false;
+    m_exitReached   = false;
+    m_tickCount     = 0;
+
+    for (int r = 0; r < gridRows; ++r) {
+        for (int c = 0; c < gridCols; ++c) {
+            if (m_grid[r][c] != 1)
+                m_walkableCells.append(QPoint(c, r));   // monster spawn points
+        }
+    }
+
+    // ---- Doors: remember which door owns each door cell ----
+    m_doors.clear();
+    m_doorAtCell.assign(gridRows * gridCols, -1);
+    for (int i = 0; i < static_cast<int>(maze.doors.size()); ++i) {
+        const MazeGenerator::Cell &d = maze.doors[i];
+        m_doors.append({ d, false });
+
+        for (int dr = 0; dr < m_blockCells; ++dr) {
+            for (int dc = 0; dc < m_blockCells; ++dc) {
+                int r = d.r + dr;
+                int c = d.c + dc;
+                if (r < gridRows && c < gridCols)
+                    m_doorAtCell[r * gridCols + c] = i;
+            }
+        }
+    }
+
+    m_keys.clear();
+    for (const MazeGenerator::Cell &k : maze.keys)
+        m_keys.append({ k, false });
+
+    m_exit    = maze.exit;
+    m_hasExit = true;
+
+    // Player stands at the start cell; sprites are two cells tall, so the
+    // feet sit one cell below the sprite centre
+    m_playerPos = QPointF(maze.start.c * m_cellSize + m_cellSize / 2.0,
+                          maze.start.r * m_cellSize + m_cellSize / 2.0 + m_cellSize);
+    m_playerPrevPos = m_playerPos;
+}
+
+void GameSimulation::loadOpenWorld(quint32 seed, const MazeGenerator::Cell &start)
+{
+    MazeGenerator::MazeData empty;
+    empty.start = start;
+    empty.seed  = seed;
+    loadLevel(empty);
+    m_hasExit = false;
+}
+
+void GameSimulation::setGridWindow(const QPoint &origin, std::vector<std::vector<int>> grid)
+{
+    m_grid       = std::move(grid);
+    m_gridOrigin = origin;
+    m_doorAtCell.assign(rows() * cols(), -1);
+}
+
+QVector<GameSimulation::Event> GameSimulation::takeEvents()
+{
+    QVector<Event> out;
+    out.swap(m_events);
+    return out;
+}
+
+void GameSimulation::emitEvent(Event::Type type, int id)
+{
+    m_events.append({ type, id });
+}
+
+void GameSimulation::step(const InputState &input)
+{
+    m_playerPrevPos = m_playerPos;
+    for (Monster &m : m_monsters)
+        m.prevPos = m.pos;
+
+    if (playerDead() || m_exitReached)
+        return;
+
+    ++m_tickCount;
+
+    if (m_slowTicksLeft > 0 && --m_slowTicksLeft == 0)
+        m_slowFactor = 1.0;
+
+    updateFacing(input);
+
+    if (input.wasPressed(InputState::Attack)) {
+        emitEvent(Event::PlayerAttacked);
+        resolvePlayerAttack();
+    }
+
+    // ---- Player movement ----
+    const qreal step = m_playerSpeed * m_slowFactor * kTickSeconds;
+    QPointF delta(0, 0);
+    if (input.isHeld(InputState::Left))  delta.rx() -= step;
+    if (input.isHeld(InputState::Right)) delta.rx() += step;
+    if (input.isHeld(InputState::Up))    delta.ry() -= step;
+    if (input.isHeld(InputState::Down))  delta.ry() += step;
+
+    m_playerMoving = input.isMoving();
+    if (!delta.isNull())
+        tryMovePlayer(delta);
+
+    if (m_exitReached)
+        return;
+
+    updateMonsters();
+}
+
+void GameSimulation::updateFacing(const InputState &input)
+{
+    const quint8 dirs = input.held & InputState::DirectionMask;
+    if (!dirs)
+        return;
+
+    auto buttonFor = [](Facing f) -> quint8 {
+        switch (f) {
+        case Left:  return InputState::Left;
+        case Right: return InputState::Right;
+        case Back:  return InputState::Up;
+        case Front: return InputState::Down;
+        }
+        return 0;
+    };
+
+    // A freshly pressed direction wins (keyboard feel); otherwise keep facing
+    // while its button stays down, else prefer horizontal, then vertical
+    quint8 candidates = input.pressed & dirs;
+    if (!candidates) {
+        if (dirs & buttonFor(m_facing))
+            return;
+        candidates = dirs;
+    }
+
+    if (candidates & InputState::Left)       m_facing = Left;
+    else if (candidates & InputState::Right) m_facing = Right;
+    else if (candidates & InputState::Up)    m_facing = Back;
+    else                                     m_facing = Front;
+}
+
+QRectF GameSimulation::feetRect(const QPointF &feet) const
+{
+    // ---- Feet collision box ----
+    qreal hitHeight = m_cellSize * 0.6;
+    qreal hitWidth  = m_cellSize * 0.6;
+
+    return QRectF(feet.x() - hitWidth / 2.0,
+                  feet.y() - hitHeight - 13.0,
+                  hitWidth,
+                  hitHeight);
+}
+
+QRectF GameSimulation::blockRect(const MazeGenerator::Cell &cell) const
+{
+    return QRectF(cell.c * m_cellSize, cell.r * m_cellSize,
+                  m_blockCells * m_cellSize, m_blockCells * m_cellSize);
+}
+
+void GameSimulation::tryMovePlayer(const QPointF &delta)
+{
+    PROFILE_SCOPE("tryMovePlayer");
+
+    const QPointF newPos = m_playerPos + delta;
+    const QRectF  feet   = feetRect(newPos);
+
+    // Grid cells overlapped by the feet box (edges only touching don't count)
+    const int c0 = static_cast<int>(std::floor(feet.left() / m_cellSize));
+    const int r0 = static_cast<int>(std::floor(feet.top() / m_cellSize));
+    const int c1 = static_cast<int>(std::ceil(feet.right() / m_cellSize)) - 1;
+    const int r1 = static_cast<int>(std::ceil(feet.bottom() / m_cellSize)) - 1;
+
+    const int gridRows = rows();
+    const int gridCols = cols();
+
+    bool blocked = false;
+    for (int r = r0 - m_gridOrigin.y(); r <= r1 - m_gridOrigin.y() && !blocked; ++r) {
+        for (int c = c0 - m_gridOrigin.x(); c <= c1 - m_gridOrigin.x(); ++c) {
+            // Outside the maze counts as wall
+            if (r < 0 || c < 0 || r >= gridRows || c >= gridCols || m_grid[r][c] == 1) {
+                blocked = true;
+                break;
+            }
+            int door = m_doorAtCell[r * gridCols + c];
+            if (door >= 0 && !m_doors[door].open) {
+                blocked = true;
+                break;
+            }
+        }
+    }
+
+    // Keys are picked up on contact, even if the step itself is blocked
+    for (int i = 0; i < m_keys.size(); ++i) {
+        Key &k = m_keys[i];
+        if (k.collected)
+            continue;
+
+        QRectF keyRect(k.cell.c * m_cellSize, k.cell.r * m_cellSize,
+                       m_cellSize, m_cellSize);
+        if (!feet.intersects(keyRect))
+            continue;
+
+        k.collected = true;
+        if (i < m_doors.size())
+            m_doors[i].open = true;   // key i unlocks door i
+        emitEvent(Event::KeyCollected, i);
+
+        spawnMonsters(4);
+    }
+
+    if (blocked)
+        return;
+
+    m_playerPos = newPos;
+
+    if (m_hasExit && feet.intersects(blockRect(m_exit))) {
+        m_exitReached = true;
+        emitEvent(Event::ExitReached);
+    }
+}
+
+void GameSimulation::spawnMonsters(int count)
+{
+    if (m_walkableCells.isEmpty())
+        return;
+
+    for (int i = 0; i < count; ++i) {
+        int idx = m_rng.bounded(int(m_walkableCells.size()));
+        QPoint cell = m_walkableCells[idx];
+
+        int r = m_rng.bounded(100);
+
+        Monster m;
+        m.id    = m_nextMonsterId++;
+        m.kind  = (r < 30 ? DamageMonster   // 30% damage monster
+                          : SlowMonster);   // 70% slow monster
+        m.speed = (m.kind == DamageMonster ? 100.0
+                                           : 200.0);   // Slow-monster is actually faster
+        m.hp    = 100;
+        m.maxHp = 100;
+        m.lastAttackTick = -1000000;
+
+        // Monsters are one cell tall, centred on the cell
+        m.pos = QPointF((m_gridOrigin.x() + cell.x()) * m_cellSize + m_cellSize / 2.0,
+                        (m_gridOrigin.y() + cell.y()) * m_cellSize + m_cellSize);
+        m.prevPos = m.pos;
+
+        m_monsters.append(m);
+        emitEvent(Event::MonsterSpawned, m.id);
+    }
+}
+
+void GameSimulation::updateMonsters()
+{
+    if (m_monsters.isEmpty())
+        return;
+
+    PROFILE_SCOPE("updateMonsters");
+
+    const QPointF playerFeet = m_playerPos;
+    const qreal attackRadius = m_cellSize * 1.0;
+
+    // ≈450ms ≈ 0.5s per attack
+    const int ticksPerHit = qRound(0.45 / kTickSeconds);
+
+    // Jitter and crowd repulsion speeds, pixels per second
+    const qreal jitterSpeed    = 8.0;
+    const qreal repulsionSpeed = 13.0;
+
+    for (int i = m_monsters.size() - 1; i >= 0; --i) {
+        Monster &m = m_monsters[i];
+
+        if (m.hp <= 0) {
+            const int id = m.id;
+            m_monsters.removeAt(i);
+            emitEvent(Event::MonsterDied, id);
+            continue;
+        }
+
+        QLineF line(m.pos, playerFeet);
+        qreal dist = line.length();
+
+        // ---- Attack: when touching, hit approx every 0.5s; don't chase ----
+        if (dist <= attackRadius) {
+            if (int(m_tickCount) - m.lastAttackTick >= ticksPerHit) {
+                if (m.kind == DamageMonster)
+                    damagePlayer(10);
+                else
+                    applySlowToPlayer(1500, 0.5);  // 1.5s slow to 50%
+
+                m.lastAttackTick = int(m_tickCount);
+            }
+            continue;
+        }
+
+        // ---- Random decision: chase player or wander ----
+        bool chase = (m_rng.bounded(100) < 85);
+
+        QPointF delta(0, 0);
+        qreal step = m.speed * kTickSeconds;
+
+        if (chase && dist > 0.1) {
+            line.setLength(step);
+            delta = QPointF(line.dx(), line.dy());
+        } else {
+            int angleDeg = m_rng.bounded(360);
+            qreal rad = angleDeg * (3.14159265 / 180.0);
+            delta = QPointF(std::cos(rad) * step,
+                            std::sin(rad) * step);
+        }
+
+        // ---- Small noisy jitter (to avoid synchronized movement) ----
+        qreal noiseX = (m_rng.bounded(100) - 50) / 50.0;
+        qreal noiseY = (m_rng.bounded(100) - 50) / 50.0;
+        delta += QPointF(noiseX, noiseY) * (jitterSpeed * kTickSeconds);
+
+        // ---- Repulsion (prevent crowding) ----
+        for (const Monster &other : m_monsters) {
+            if (other.id == m.id) continue;
+
+            qreal d = QLineF(m.pos, other.pos).length();
+            if (d < (m_cellSize * 1.1) && d > 0.01) {
+                QPointF diff = (m.pos - other.pos) / d;
+                delta += diff * (repulsionSpeed * kTickSeconds);
+            }
+        }
+
+        m.pos += delta;
+
+        if (playerDead())
+            return;
+    }
+}
+
+void GameSimulation::damagePlayer(int amount)
+{
+    m_playerHp -= amount;
+    if (m_playerHp < 0)
+        m_playerHp = 0;
+
+    emitEvent(Event::PlayerDamaged);
+    if (m_playerHp <= 0)
+        emitEvent(Event::PlayerDied);
+}
+
+void GameSimulation::applySlowToPlayer(int durationMs, qreal factor)
+{
+    if (m_slowTicksLeft > 0)
+        return;
+
+    m_slowFactor    = factor;
+    m_slowTicksLeft = qMax(1, qRound(durationMs / 1000.0 / kTickSeconds));
+    emitEvent(Event::PlayerSlowed);
+}
+
+void GameSimulation::resolvePlayerAttack()
+{
+    const QPointF feet = m_playerPos;
+
+    QRectF attackRect;
+    qreal w = m_cellSize;
+    qreal h = m_cellSize;
+
+    switch (m_facing) {
+    case Front:
+        attackRect = QRectF(feet.x() - w/2.0, feet.y(), w, h);
+        break;
+    case Back:
+        attackRect = QRectF(feet.x() - w/2.0, feet.y() - h, w, h);
+        break;
+    case Left:
+        attackRect = QRectF(feet.x() - w, feet.y() - h/2.0, w, h);
+        break;
+    case Right:
+        attackRect = QRectF(feet.x(), feet.y() - h/2.0, w, h);
+        break;
+    }
+
+    // Attack only the closest monster
+    Monster *closest = nullptr;
+    qreal bestDist = 1e9;
+
+    for (Monster &m : m_monsters) {
+        if (m.hp <= 0)
+            continue;
+
+        QRectF body(m.pos.x() - m_cellSize / 2.0, m.pos.y() - m_cellSize,
+                    m_cellSize, m_cellSize);
+        if (!attackRect.intersects(body))
+            continue;
+
+        qreal d = QLineF(feet, m.pos).length();
+        if (d < bestDist) {
+            bestDist = d;
+            closest = &m;
+        }
+    }
+
+    if (closest) {
+        closest->hp = qMax(0, closest->hp - 40);
+        emitEvent(Event::MonsterHit, closest->id);
+    }
+}
+
+// ---- Is the target position inside a non-wall cell? ----
+bool GameSimulation::isWalkable(const QPointF &pos) const
+{
+    if (m_grid.empty())
+        return false;
+
+    int col = static_cast<int>(std::floor(pos.x() / m_cellSize)) - m_gridOrigin.x();
+    int row = static_cast<int>(std::floor(pos.y() / m_cellSize)) - m_gridOrigin.y();
+
+    if (row < 0 || col < 0 || row >= rows() || col >= cols())
+        return false;
+
+    // 1 means wall; non-wall is walkable
+    return (m_grid[row][col] != 1);
+}
+
+quint64 GameSimulation::stateHash() const
+{
+    quint64 h = 14695981039346656037ull;
+    auto mix = [&h](const void *data, size_t len) {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < len; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    auto mixPoint = [&mix](const QPointF &pt) {
+        double xy[2] = { pt.x(), pt.y() };
+        mix(xy, sizeof(xy));
+    };
+
+    mix(&m_tickCount, sizeof(m_tickCount));
+    mixPoint(m_playerPos);
+    mix(&m_playerHp, sizeof(m_playerHp));
+    mix(&m_slowTicksLeft, sizeof(m_slowTicksLeft));
+    int facing = m_facing;
+    mix(&facing, sizeof(facing));
+
+    for (const Monster &m : m_monsters) {
+        mix(&m.id, sizeof(m.id));
+        mixPoint(m.pos);
+        mix(&m.hp, sizeof(m.hp));
+    }
+    for (const Door &d : m_doors) {
+        char open = d.open;
+        mix(&open, 1);
+    }
+    for (const Key &k : m_keys) {
+        char collected = k.collected;
+        mix(&collected, 1);
+    }
+    return h;
+}
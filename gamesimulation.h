@@ -0,0 +1,172 @@
+#ifndef GAMESIMULATION_H
+#define GAMESIMULATION_H
+
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <QRandomGenerator>
+#include <vector>
+
+#include "inputstate.h"
+#include "mazegenerator.h"
+
+// Gameplay rules of one level (movement, collision, keys/doors, monster AI,
+// combat) advanced in fixed ticks. Depends on QtCore only: no scene, no
+// painting, no timers, so it can run headless and as fast as the CPU allows.
+// GameView renders its state and feeds it input.
+class GameSimulation
+{
+public:
+    // Same order as PlayerItem::Direction
+    enum Facing { Front, Back, Left, Right };
+
+    enum MonsterKind {
+        DamageMonster,   // hits the player
+        SlowMonster      // slows the player down
+    };
+
+    // Positions are "feet" points: bottom-centre of the sprite
+    struct Monster {
+        int         id;
+        MonsterKind kind;
+        QPointF     pos;
+        QPointF     prevPos;          // position at the previous tick
+        qreal       speed;            // pixels per second
+        int         hp;
+        int         maxHp;
+        int         lastAttackTick;
+    };
+
+    struct Door {
+        MazeGenerator::Cell cell;     // top-left of the door block
+        bool open;
+    };
+
+    struct Key {
+        MazeGenerator::Cell cell;
+        bool collected;
+    };
+
+    // Things the renderer has to react to; `id` is a monster id or key/door index
+    struct Event {
+        enum Type {
+            KeyCollected,      // id = key index (door with the same index opened)
+            MonsterSpawned,    // id = monster id
+            MonsterHit,        // id = monster id
+            MonsterDied,       // id = monster id (already removed)
+            PlayerAttacked,    // player started an attack
+            PlayerDamaged,
+            PlayerSlowed,
+            PlayerDied,
+            ExitReached
+        };
+        Type type;
+        int  id;
+    };
+
+    static constexpr qreal kTickSeconds = 1.0 / 60.0;
+
+    explicit GameSimulation(int cellSize = 32);
+
+    // A session is fully determined by its seed and the per-tick inputs
+    void    setSeed(quint32 seed);
+    quint32 seed() const { return m_seed; }
+    quint32 nextLevelSeed();              // seed for the next MazeGenerator
+
+    void loadLevel(const MazeGenerator::MazeData &maze);
+
+    // Open world: no exit, doors, keys or monsters, and the grid is a
+    // window onto an endless maze whose top-left is world cell `origin`.
+    // Positions stay in world coordinates; cells outside the window are
+    // wall. The owner moves the window along with the player.
+    void loadOpenWorld(quint32 seed, const MazeGenerator::Cell &start);
+    void setGridWindow(const QPoint &origin, std::vector<std::vector<int>> grid);
+    QPoint gridOrigin() const { return m_gridOrigin; }
+
+    // Advance one fixed tick
+    void step(const InputState &input);
+
+    // Events produced since the last call
+    QVector<Event> takeEvents();
+
+    // ---- State for rendering ----
+    int cellSize() const { return m_cellSize; }
+    const std::vector<std::vector<int>> &grid() const { return m_grid; }
+    int rows() const { return static_cast<int>(m_grid.size()); }
+    int cols() const { return m_grid.empty() ? 0 : static_cast<int>(m_grid[0].size()); }
+    int blockCells() const { return m_blockCells; }
+
+    QPointF playerPos() const     { return m_playerPos; }
+    QPointF playerPrevPos() const { return m_playerPrevPos; }
+    Facing  facing() const        { return m_facing; }
+    bool    playerMoving() const  { return m_playerMoving; }
+    int     playerHp() const      { return m_playerHp; }
+    int     playerMaxHp() const   { return m_playerMaxHp; }
+    bool    playerSlowed() const  { return m_slowTicksLeft > 0; }
+    bool    playerDead() const    { return m_playerHp <= 0; }
+    bool    exitReached() const   { return m_exitReached; }
+
+    const QVector<Monster> &monsters() const { return m_monsters; }
+    const QVector<Door>    &doors() const    { return m_doors; }
+    const QVector<Key>     &keys() const     { return m_keys; }
+    MazeGenerator::Cell     exitCell() const { return m_exit; }
+
+    quint64 tickCount() const { return m_tickCount; }
+
+    // FNV-1a over everything that evolves during play; equal hashes after
+    // the same number of ticks mean the runs were bit-identical
+    quint64 stateHash() const;
+
+    // Is this world position inside a non-wall cell?
+    bool isWalkable(const QPointF &pos) const;
+
+    void spawnMonsters(int count);
+
+private:
+    QRectF feetRect(const QPointF &feet) const;
+    QRectF blockRect(const MazeGenerator::Cell &cell) const;
+    void   updateFacing(const InputState &input);
+    void   tryMovePlayer(const QPointF &delta);   // movement + collision handling
+    void   resolvePlayerAttack();
+    void   updateMonsters();
+    void   damagePlayer(int amount);
+    void   applySlowToPlayer(int durationMs, qreal factor);
+    void   emitEvent(Event::Type type, int id = -1);
+
+    int m_cellSize;
+    int m_blockCells = 2;   // fine cells per coarse maze cell
+
+    std::vector<std::vector<int>> m_grid;        // 1 = wall, 2 = door
+    QPoint                        m_gridOrigin;  // world cell of m_grid[0][0]
+    std::vector<int>              m_doorAtCell;  // door index per cell, -1 if none
+    QVector<QPoint>               m_walkableCells;
+
+    QPointF m_playerPos;
+    QPointF m_playerPrevPos;
+    Facing  m_facing       = Front;
+    bool    m_playerMoving = false;
+    qreal   m_playerSpeed  = 420.0;   // pixels per second
+    int     m_playerMaxHp  = 300;
+    int     m_playerHp     = 300;
+    int     m_slowTicksLeft = 0;
+    qreal   m_slowFactor    = 1.0;
+
+    QVector<Monster> m_monsters;
+    int              m_nextMonsterId = 0;
+
+    QVector<Door>       m_doors;
+    QVector<Key>        m_keys;
+    MazeGenerator::Cell m_exit { 0, 0 };
+    bool                m_hasExit = true;
+    bool                m_exitReached = false;
+
+    quint64 m_tickCount = 0;
+
+    quint32          m_seed = 0;
+    QRandomGenerator m_sessionRng;   // level seeds
+    QRandomGenerator m_rng;          // in-level randomness (monsters)
+    QVector<Event>   m_events;
+};
+
+#endif // GAMESIMULATION_H
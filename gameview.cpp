@@ -1,37 +1,56 @@
 #include "gameview.h"
+#include "assetcache.h"
 #include "mazegenerator.h"
 #include "playercontroller.h"
+#include "gpiocontroller.h"
+#include "frameprofiler.h"
+#include "inputclock.h"
 
 #include <QKeyEvent>
-#include <QRandomGenerator>
 #include <QCoreApplication>
 #include <QDir>
 #include <QApplication>
-#include <QLineF>
+#include <QDateTime>
+#include <QPaintEvent>
+#include <QPainter>
 #include <QDebug>
+#include <QtConcurrent>
 
-GameView::GameView(const QString &characterName, QWidget *parent)
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+GameView::GameView(const QString &characterName,
+                   const LaunchOptions &options,
+                   QWidget *parent)
     : QGraphicsView(parent),
-    m_scene(new QGraphicsScene(this)),
+    m_scene(new LevelScene(this)),
     m_player(nullptr),
     m_exitTile(nullptr),
     m_characterName(characterName),
-    m_step(6),
-    m_cellSize(32),
+    m_cellSize(kCellSize),
     m_rowsCells(10),
     m_colsCells(15),
     m_loader(nullptr),
-#if CONTROL == GPIO
-    m_controller(15, this)        // GPIO / OTHER mode
-#else
-    m_controller(15)              // KEYBOARD mode
-#endif
+    m_sim(m_cellSize)
 {
+    m_openWorld = options.openWorld;
+
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    setScene(m_scene);
+
+    // The static maze is the scene background: cache it, scroll the cache
+    // by whole pixels and repaint only the rects moving sprites dirty
+    setCacheMode(QGraphicsView::CacheBackground);
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState |
+                         QGraphicsView::DontAdjustForAntialiasing);
 
     setFixedSize(480, 272);
+    setupSoftRenderer(options);
+    if (!m_softRendering)
+        setScene(m_scene);
     setFocusPolicy(Qt::StrongFocus);
     setFocus();
 
@@ -40,745 +59,1099 @@ GameView::GameView(const QString &characterName, QWidget *parent)
     m_loader->setGif(base + "/texture/loading_screen/loading-pixel.gif");
     m_loader->setGeometry(rect());
     m_loader->hide();
+
+    m_minimap = new Minimap(this);
+
+    m_debugOverlay = new DebugOverlay(this);
+    m_debugOverlay->setInputLatency(&m_inputLatency);
+
+    // ---- Session seed: from the replayed log, the command line or random ----
+    if (!options.replayPath.isEmpty()) {
+        QString error;
+        if (m_replay.open(options.replayPath, &error))
+            m_sim.setSeed(m_replay.seed());
+        else
+            qWarning() << "[GameView] Replay disabled:" << error;
+    } else if (options.hasSeed) {
+        m_sim.setSeed(options.seed);
+    }
+    qDebug() << "[GameView] Session seed" << m_sim.seed();
+
+    if (!options.recordPath.isEmpty())
+        m_recorder.open(options.recordPath, m_sim.seed());
+
+    createInputBackends(options);
+
+    // A quit (e.g. after dying) still leaves a complete log behind
+    connect(qApp, &QCoreApplication::aboutToQuit,
+            this, &GameView::finishRecording);
+
+    connect(&m_levelLoader, &LevelLoader::loaded,
+            this, &GameView::finishLoadNextLevel);
+    m_sceneBuilder.setBudgetMs(kSceneSliceBudget);
+
+    m_sceneTeardown.setBudgetMs(kSceneSliceBudget / 2);
+
+    m_fovEnabled = options.fov && !m_openWorld;
+    if (options.fov && m_openWorld)
+        qWarning() << "[GameView] Line of sight needs a fixed level; --fov ignored";
+    m_fov.setRadius(options.fovRadius);
+
+    m_world.setMemoryBudget(qint64(options.worldBudgetMb) * 1024 * 1024);
+    connect(&m_world, &WorldStreamer::chunkReady, this, &GameView::onWorldChunkReady);
+    connect(&m_world, &WorldStreamer::chunkEvicted, this, &GameView::onWorldChunkEvicted);
+
     loadNextLevel();
 
     if (m_player)
         centerOn(m_player);
 
-    // movement timer: ~60 FPS
-    connect(&m_moveTimer, &QTimer::timeout, this, &GameView::stepMovement);
-    m_moveTimer.setInterval(16); // ms (approx 60 FPS)
-    m_moveTimer.start();
+    // One game loop for input, simulation and rendering.
+    // The timer only wakes us up; how far to simulate comes from the clock.
+    connect(&m_frameTimer, &QTimer::timeout, this, &GameView::frameTick);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    m_frameTimer.setInterval(16);
+    m_frameClock.start();
+    resetFrameClock();
+    m_frameTimer.start();
+}
 
-    // Monster AI updates every 30ms (~33 FPS), and also refreshes player HP bar
-    connect(&m_monsterAITimer, &QTimer::timeout, this, [this]() {
-        if (!m_player)
-            return;
-        updateMonsters();      // Monster pathfinding + attacks
-        updatePlayerHpBar();   // HP bar follows player
-        ++m_tickCount;         // Controls monster attack timing
-    });
-    m_monsterAITimer.setInterval(30);
-    m_monsterAITimer.start();
+GameView::~GameView()
+{
+    finishRecording();
 }
 
-void GameView::loadNextLevel()
+void GameView::resetFrameClock()
 {
-    if (m_isLoading)
+    m_lastFrameNs = m_frameClock.nsecsElapsed();
+    m_accumulator = 0.0;
+}
+
+void GameView::frameTick()
+{
+    if (!m_player || m_isLoading)
         return;
 
-    m_isLoading = true;
+    PROFILE_SCOPE("frame");
+    FrameProfiler::instance().markFrame();
+
+    const qint64 nowNs = m_frameClock.nsecsElapsed();
+    qreal frameTime = (nowNs - m_lastFrameNs) / 1e9;
+    m_lastFrameNs = nowNs;
+
+    // After a long stall, drop the backlog instead of trying to catch up
+    if (frameTime > kMaxFrameTime)
+        frameTime = kMaxFrameTime;
+    m_accumulator += frameTime;
+
+    // Fixed steps: identical simulation no matter how irregular frames are.
+    // Once the player has died nothing is simulated any more, but frames
+    // keep coming so the death animation plays out
+    while (m_accumulator >= kSimStep && !m_sim.playerDead()) {
+        stepMovement();
+        m_accumulator -= kSimStep;
+        if (m_openWorld)
+            updateWorldFocus();
+
+        // Exit reached: the level is being torn down
+        if (m_isLoading)
+            return;
+    }
+    if (m_sim.playerDead())
+        m_accumulator = 0.0;
 
-    // Stop monster AI to avoid accessing deleted monsters
-    m_monsterAITimer.stop();
+    renderInterpolated(m_accumulator / kSimStep);
 
-    // Show GIF overlay
-    if (m_loader) {
-        m_loader->showOverlay();
-    }
+    m_animationClock.advance(nowNs, visibleSceneRect());
 
-    QApplication::processEvents();
+    if (m_softRendering)
+        renderSoftFrame();
+}
 
-    QTimer::singleShot(500, this, &GameView::finishLoadNextLevel);
+QPoint GameView::playerCell() const
+{
+    const QPointF feet = m_sim.playerPos();
+    return QPoint(int(std::floor(feet.x() / m_cellSize)),
+                  int(std::floor(feet.y() / m_cellSize)));
 }
 
-void GameView::finishLoadNextLevel()
+void GameView::updateFieldOfView()
 {
-    buildMaze();
+    const QRect before = m_fov.bounds();
+    if (!m_fov.update(playerCell()))
+        return;
 
-    if (m_loader) {
-        m_loader->hideOverlay();
+    // The cached background is redrawn where the lit area was or now is
+    const QRect cells = before | m_fov.bounds();
+    m_scene->invalidate(QRectF(cells.x() * m_cellSize, cells.y() * m_cellSize,
+                               cells.width() * m_cellSize, cells.height() * m_cellSize),
+                        QGraphicsScene::BackgroundLayer);
+
+    // Props would give the layout away just like tiles
+    if (m_exitTile)
+        m_exitTile->setVisible(isInSight(m_exitTile));
+    for (QGraphicsPixmapItem *door : m_doors)
+        door->setVisible(isInSight(door));
+    for (QGraphicsPixmapItem *key : m_keys) {
+        if (key)
+            key->setVisible(isInSight(key));
     }
+}
 
-    if (m_player) {
-        centerOn(m_player);
+bool GameView::isInSight(const QGraphicsItem *item) const
+{
+    const QRectF r = item->sceneBoundingRect();
+    const int c0 = int(std::floor(r.left() / m_cellSize));
+    const int r0 = int(std::floor(r.top()  / m_cellSize));
+    const int c1 = int(std::ceil(r.right()  / m_cellSize)) - 1;
+    const int r1 = int(std::ceil(r.bottom() / m_cellSize)) - 1;
+
+    for (int row = r0; row <= r1; ++row) {
+        for (int col = c0; col <= c1; ++col) {
+            if (m_fov.isVisible(row, col))
+                return true;
+        }
     }
-
-    // Restart monster AI
-    m_monsterAITimer.start();
-
-    m_isLoading = false;
+    return false;
 }
 
-void GameView::buildMaze()
+QRectF GameView::visibleSceneRect() const
 {
-    m_scene->clear();
-    m_player   = nullptr;
-    m_exitTile = nullptr;
-    m_doors.clear();
+    if (m_softRendering)
+        return QRectF(m_softCamera, m_softRenderer.frame().size());
+    return mapToScene(viewport()->rect()).boundingRect();
+}
 
-    // ---- Reset state (scene already cleared all items) ----
-    m_monsters.clear();       // Only clear container; do not manually delete
-    m_walkableCells.clear();
-    m_monstersSpawned = false;
-    m_playerHp        = m_playerMaxHp;
-    m_playerSlowed    = false;
-    m_tickCount       = 0;
+void GameView::stepMovement()
+{
+    qint64 captureNs = 0;
+    InputState in = nextInput(&captureNs);
+    m_recorder.record(in);
+
+    // What an input can change on screen
+    const QPointF                pos    = m_sim.playerPos();
+    const GameSimulation::Facing facing = m_sim.facing();
+    const bool                   moving = m_sim.playerMoving();
+    const PlayerItem::Action     action = m_player->action();
+
+    m_sim.step(in);
+    handleSimEvents();
+
+    // The next paint is the first to show this input's effect. Input that
+    // changed nothing has no effect to wait for: timing the next unrelated
+    // paint would count idle time as latency, and a level load is not one
+    const bool changed = !m_isLoading
+                         && (m_sim.playerPos() != pos || m_sim.facing() != facing
+                             || m_sim.playerMoving() != moving
+                             || m_player->action() != action);
+    if (captureNs && changed && (!m_latencyPendingNs || captureNs < m_latencyPendingNs))
+        m_latencyPendingNs = captureNs;
+}
 
-    QString base = QCoreApplication::applicationDirPath();
-    m_wallSet  = loadRandomTextureSet(wallFamilies(),  m_cellSize,
-                                     base + "/texture/walls/");
-    m_floorSet = loadRandomTextureSet(floorFamilies(), m_cellSize,
-                                      base + "/texture/floor/");
+InputState GameView::nextInput(qint64 *captureNs)
+{
+    // Live input is still merged during a replay so edges don't pile up
+    bool replayed = false;
+    InputState in = m_input.takeInputState(captureNs, &replayed);
+
+    // Log used up (or out of step with the level): back to live control
+    if (m_replay.isOpen() && !replayed)
+        finishReplay();
+    return in;
+}
 
-    // Generate maze data (grid + start + exit + doors + keys)
-    MazeGenerator gen(m_rowsCells, m_colsCells);
-    MazeGenerator::MazeData maze = gen.generate();
+void GameView::createInputBackends(const LaunchOptions &options)
+{
+    for (const QString &entry : options.inputs) {
+        const QString name = entry.trimmed();
+        if (name == "keyboard") {
+            m_input.addBackend(new PlayerController());
+        } else if (name == "gpio") {
+            GpioController *gpio = new GpioController();
+            gpio->setSysfsRoot(options.gpioRoot);
+            gpio->setChipDevice(options.gpioChip);
+            gpio->setGpios(options.gpioPins[0], options.gpioPins[1],
+                           options.gpioPins[2], options.gpioPins[3],
+                           options.gpioPins[4]);
+            m_input.addBackend(gpio);
+        } else if (name != "replay") {
+            qWarning() << "[GameView] Unknown input backend" << name;
+        }
+    }
 
-    // Save a copy of maze grid for monster collision (1 = wall)
-    m_grid = maze.grid;
+    // A replay log drives the game whenever one was given
+    if (m_replay.isOpen())
+        m_input.addBackend(new ReplayInputBackend(&m_replay));
 
-    const auto &grid = maze.grid;
-    int gridRows = static_cast<int>(grid.size());
-    int gridCols = static_cast<int>(grid[0].size());
+    qDebug() << "[GameView] Input backends" << m_input.backendNames();
+}
 
-    int coarseRows = 2 * m_rowsCells + 1;
-    int cellScale = gridRows / coarseRows;
+void GameView::finishReplay()
+{
+    if (!m_replay.isOpen())
+        return;
 
-    // Scene size in pixels
-    int sceneWidth  = gridCols * m_cellSize;
-    int sceneHeight = gridRows * m_cellSize;
-    m_scene->setSceneRect(0, 0, sceneWidth, sceneHeight);
-    setScene(m_scene);
-
-    // --- Draw floor tiles for all walkable cells ---
-    for (int r = 0; r < gridRows; ++r) {
-        for (int c = 0; c < gridCols; ++c) {
-            if (grid[r][c] == 1)
-                continue;
-
-            // Record all "non-wall" cells; later used for random monster spawn
-            m_walkableCells.append(QPoint(c, r));
-
-            int x = c * m_cellSize;
-            int y = r * m_cellSize;
-
-            QBrush brush = m_floorSet.randomBrush();
-            if (brush.texture().isNull())
-                continue;
-
-            auto *floor = m_scene->addRect(
-                x, y,
-                m_cellSize, m_cellSize,
-                QPen(Qt::NoPen),
-                brush
-                );
-            floor->setZValue(-2);  // behind everything
-            floor->setData(0, "floor");
-        }
+    if (m_replay.peek() == InputReplay::End && m_replay.hasFooter()) {
+        bool match = m_replay.recordedHash() == m_sim.stateHash();
+        qDebug() << "[GameView] Replay finished:"
+                 << (match ? "matches recording" : "DIVERGED from recording");
+    } else {
+        qDebug() << "[GameView] Replay finished";
     }
+    m_replay.close();
+}
 
-    // Draw walls only
-    for (int r = 0; r < gridRows; ++r) {
-        for (int c = 0; c < gridCols; ++c) {
-            if (grid[r][c] != 1)
-                continue;
+void GameView::finishRecording()
+{
+    m_recorder.finish(m_sim.stateHash());
+}
 
-            int x = c * m_cellSize;
-            int y = r * m_cellSize;
+void GameView::handleSimEvents()
+{
+    const QVector<GameSimulation::Event> events = m_sim.takeEvents();
+    if (events.isEmpty()) {
+        syncPlayerAnimation();
+        return;
+    }
 
-            QBrush brush = m_wallSet.randomBrush();
-            if (brush.texture().isNull())
-                continue;
+    for (const GameSimulation::Event &e : events) {
+        switch (e.type) {
+        case GameSimulation::Event::KeyCollected: {
+            if (e.id < static_cast<int>(m_keys.size()) && m_keys[e.id]) {
+                m_scene->removeItem(m_keys[e.id]);
+                delete m_keys[e.id];
+                m_keys[e.id] = nullptr;
+            }
 
-            auto *wall = m_scene->addRect(
-                x, y,
-                m_cellSize, m_cellSize,
-                QPen(Qt::NoPen),
-                brush
-                );
-            wall->setData(0, "wall");
-            wall->setZValue(-1);  // above floor, below keys/player
+            // Key i unlocks door i
+            if (e.id >= 0 && e.id < static_cast<int>(m_doors.size())) {
+                if (!m_openDoorPix.isNull())
+                    m_doors[e.id]->setPixmap(m_openDoorPix);
+
+                // An open door no longer blocks sight
+                const MazeGenerator::Cell d = m_sim.doors()[e.id].cell;
+                for (int dr = 0; dr < m_sim.blockCells(); ++dr)
+                    for (int dc = 0; dc < m_sim.blockCells(); ++dc)
+                        m_fov.setOpaque(d.r + dr, d.c + dc, false);
+                m_minimap->openDoor(QRect(d.c, d.r, m_sim.blockCells(), m_sim.blockCells()));
+            }
+            break;
         }
-    }
-
-    // Draw EXIT (2x2 block)
-    {
-        int exitX = maze.exit.c * m_cellSize;
-        int exitY = maze.exit.r * m_cellSize;
 
-        QString exitPath = base + "/texture/exit/stone_stairs_down.png";
-        QPixmap exitTex(exitPath);
+        case GameSimulation::Event::MonsterSpawned: {
+            for (const GameSimulation::Monster &m : m_sim.monsters()) {
+                if (m.id != e.id)
+                    continue;
+
+                const QPixmap &pix = (m.kind == GameSimulation::DamageMonster
+                                          ? m_damagePix : m_slowPix);
+                MonsterItem *item = m_monsterPool.acquire(pix);
+                item->setFeetPos(m.pos);
+                m_monsterItems.insert(m.id, item);
+                break;
+            }
+            break;
+        }
 
-        int exitW = cellScale * m_cellSize;
-        int exitH = cellScale * m_cellSize;
+        case GameSimulation::Event::MonsterHit:
+            // The HUD reads health from the simulation
+            break;
 
-        if (!exitTex.isNull()) {
-            QPixmap scaledExit = exitTex.scaled(
-                exitW, exitH,
-                Qt::KeepAspectRatioByExpanding,
-                Qt::SmoothTransformation
-                );
+        case GameSimulation::Event::MonsterDied: {
+            if (MonsterItem *item = m_monsterItems.take(e.id))
+                m_monsterPool.release(item);
+            break;
+        }
 
-            auto *exitItem = m_scene->addPixmap(scaledExit);
-            exitItem->setPos(exitX, exitY);
-            exitItem->setData(0, "exit");
-            exitItem->setZValue(-0.5);
+        case GameSimulation::Event::PlayerAttacked:
+            if (m_player->action() != PlayerItem::Dying)
+                m_player->setAction(PlayerItem::Attack);
+            break;
+
+        case GameSimulation::Event::PlayerDamaged:
+            qDebug() << "[GameView] Player HP:" << m_sim.playerHp()
+                     << "/" << m_sim.playerMaxHp();
+            break;
+
+        case GameSimulation::Event::PlayerSlowed:
+            break;
+
+        case GameSimulation::Event::PlayerDied:
+            // Simple handling: stop simulating & play death action; the
+            // frame loop keeps rendering and animating (frameTick)
+            finishRecording();
+            m_player->setAction(PlayerItem::Dying);
+            QTimer::singleShot(6000, this, [](){
+                QApplication::quit();  // Quit whole program
+            });
+            return;
 
-            m_exitTile = exitItem;
+        case GameSimulation::Event::ExitReached:
+            // Monster items stay until the level's scene is retired
+            loadNextLevel();
+            viewport()->update();
+            return;
         }
     }
 
-    // Draw doors
-    for (int i = 0; i < static_cast<int>(maze.doors.size()); ++i) {
-        MazeGenerator::Cell d = maze.doors[i];
-        int doorX = d.c * m_cellSize;
-        int doorY = d.r * m_cellSize;
+    syncPlayerAnimation();
+}
 
-        QPixmap doorTex(base + "/texture/doors/closed/dngn_closed_door.png");
+void GameView::syncPlayerAnimation()
+{
+    if (!m_player || m_player->action() == PlayerItem::Dying)
+        return;
 
-        int doorW = cellScale * m_cellSize;
-        int doorH = cellScale * m_cellSize;
+    m_player->setDirection(static_cast<PlayerItem::Direction>(m_sim.facing()));
 
-        QPixmap scaledDoor = doorTex.scaled(
-            doorW, doorH,
-            Qt::KeepAspectRatioByExpanding,
-            Qt::SmoothTransformation
-            );
+    // IMPORTANT: do NOT override Attack animation; it returns to Idle itself
+    if (m_player->action() == PlayerItem::Attack)
+        return;
 
-        auto *doorItem = m_scene->addPixmap(scaledDoor);
-        doorItem->setPos(doorX, doorY);
-        doorItem->setData(0, "door");
-        doorItem->setData(1, false);   // locked
-        doorItem->setZValue(0);
-        m_doors.push_back(doorItem);
-    }
+    m_player->setAction(m_sim.playerMoving() ? PlayerItem::Run
+                                             : PlayerItem::Idle);
+}
 
-    // Draw keys
-    for (int i = 0; i < static_cast<int>(maze.keys.size()); ++i) {
-        MazeGenerator::Cell k = maze.keys[i];
-        QPixmap keyTex(base + "/texture/keys/key.png");
-        if (!keyTex.isNull())
-        {
-            int keyWidth  = m_cellSize * 0.8;
-            int keyHeight = m_cellSize * 1.2;
+void GameView::updateCamera()
+{
+    // Fractional centres would scroll by sub-pixel amounts, which the
+    // background cache cannot blit
+    const QPointF c = m_player->sceneBoundingRect().center();
+    const QPointF center(qRound(c.x()), qRound(c.y()));
+    if (center == m_cameraCenter)
+        return;
 
-            QPixmap scaledKey = keyTex.scaled(
-                keyWidth, keyHeight,
-                Qt::KeepAspectRatio,
-                Qt::SmoothTransformation
-                );
+    m_cameraCenter = center;
+    if (!m_softRendering) {
+        centerOn(center);
+        return;
+    }
 
-            int keyX = k.c * m_cellSize + (m_cellSize - scaledKey.width()) / 2;
-            int keyY = k.r * m_cellSize + (m_cellSize - scaledKey.height()) / 2;
+    // Clamped like centerOn: inside the level, centred when it is smaller
+    const QSize view = m_softRenderer.frame().size();
+    const QRect level = m_scene->sceneRect().toRect();
+    auto axis = [](int c, int view, int level) {
+        return level > view ? qBound(0, c - view / 2, level - view) : (level - view) / 2;
+    };
+    m_softCamera = QPoint(axis(int(center.x()), view.width(),  level.width()),
+                          axis(int(center.y()), view.height(), level.height()));
+}
 
-            auto *keyItem = m_scene->addPixmap(scaledKey);
-            keyItem->setPos(keyX, keyY);
-            keyItem->setData(0, "key");
-            keyItem->setData(1, i);       // door index
-            keyItem->setZValue(1);
-        }
+void GameView::renderInterpolated(qreal alpha)
+{
+    // Sim positions are feet points; sprites hang above them
+    const QPointF prev = m_sim.playerPrevPos();
+    const QPointF feet = prev + (m_sim.playerPos() - prev) * alpha;
+
+    QRectF b = m_player->boundingRect();
+    const QPointF renderPos(feet.x() - b.width() / 2.0, feet.y() - b.height());
+    if (renderPos != m_player->pos()) {
+        m_player->setPos(renderPos);
+        updateCamera();
     }
 
-    // Create player
-    QString chosenCharacter = m_characterName;
-    QDir appDir(QCoreApplication::applicationDirPath());
-    QString spriteRoot = appDir.filePath("characters/" + chosenCharacter);
+    if (m_fovEnabled)
+        updateFieldOfView();
 
-    m_player = new PlayerItem(spriteRoot, m_cellSize);
-    m_scene->addItem(m_player);
+    for (const GameSimulation::Monster &m : m_sim.monsters()) {
+        MonsterItem *item = m_monsterItems.value(m.id);
+        if (!item)
+            continue;
+        item->setFeetPos(m.prevPos + (m.pos - m.prevPos) * alpha);
 
-    // ---- Create HP bar above the player's head ----
-    m_playerHpBg = new QGraphicsRectItem();
-    m_playerHpFg = new QGraphicsRectItem();
+        // Hidden items are skipped when painting
+        if (m_fovEnabled)
+            item->setVisible(m_fov.isVisible(int(std::floor(m.pos.y() / m_cellSize)),
+                                             int(std::floor(m.pos.x() / m_cellSize))));
+    }
 
-    m_playerHpBg->setBrush(Qt::red);
-    m_playerHpBg->setPen(Qt::NoPen);
-    m_playerHpFg->setBrush(Qt::green);
-    m_playerHpFg->setPen(Qt::NoPen);
+    updateHud();
 
-    m_playerHpBg->setZValue(9999);
-    m_playerHpFg->setZValue(10000);
+    // Exploring goes on while the map is hidden
+    m_minimap->setPlayerCell(playerCell());
 
-    m_scene->addItem(m_playerHpBg);
-    m_scene->addItem(m_playerHpFg);
+    if (m_debugOverlay->isVisible())
+        m_debugOverlay->update();
+}
 
-    updatePlayerHpBar();
+void GameView::loadNextLevel()
+{
+    if (m_isLoading)
+        return;
 
-    // Position player at start cell
-    qreal px = maze.start.c * m_cellSize + m_cellSize / 2.0;
-    qreal py = maze.start.r * m_cellSize + m_cellSize / 2.0;
+    m_isLoading = true;
+    m_latencyPendingNs = 0;   // a level load is not input latency
 
-    QRectF b = m_player->boundingRect();
-    m_player->setPos(px - b.width() / 2.0, py - b.height() / 2.0);
+    // Stop the game loop to avoid accessing deleted monsters
+    m_frameTimer.stop();
 
-    // Step size for movement
-    m_step = 7;
-    m_controller.setPlayer(m_player);
-    m_controller.setStep(m_step);
-#if CONTROL == GPIO
-    m_controller.setGpios(67, 68, 44, 26, 46);
+    // Show GIF overlay
+    if (m_loader) {
+        m_loader->showOverlay();
+    }
 
-    connect(&m_controller,
-            &GpioController::attackTriggered,
-            this,
-            &GameView::resolvePlayerAttack);
-#endif
+    // Everything up to the scene hookup runs off the GUI thread, so the
+    // loading animation keeps playing
+    LevelRequest req;
+    req.rows      = m_rowsCells;
+    req.cols      = m_colsCells;
+    req.cellSize  = m_cellSize;
+    req.seed      = m_sim.nextLevelSeed();
+    req.assetRoot = QCoreApplication::applicationDirPath();
+    if (m_playerSprites.isEmpty())
+        req.spriteRoot = spriteRoot(m_characterName);
+
+    m_loadClock.start();
+    m_levelLoader.start(req);
 }
 
-void GameView::updatePlayerHpBar()
+QString GameView::spriteRoot(const QString &characterName)
 {
-    if (!m_player || !m_playerHpBg || !m_playerHpFg)
-        return;
-
-    QRectF pb = m_player->boundingRect();
+    return QDir(QCoreApplication::applicationDirPath()).filePath("characters/" + characterName);
+}
 
-    // Center-top of player (scene coordinates)
-    QPointF topCenter = m_player->mapToScene(
-        QPointF(pb.center().x(), pb.top())
-        );
+QVector<AssetRequest> GameView::warmUpRequests(const QStringList &characterNames)
+{
+    QStringList roots;
+    for (const QString &name : characterNames)
+        roots << spriteRoot(name);
+    return LevelLoader::warmUpRequests(QCoreApplication::applicationDirPath(),
+                                       kCellSize, roots);
+}
 
-    qreal w = m_cellSize * 1.0;
-    qreal h = 6.0;
+void GameView::finishLoadNextLevel(const LevelAssets &assets)
+{
+    QElapsedTimer hookup;
+    hookup.start();
 
-    QPointF pos(topCenter.x() - w/2.0, topCenter.y() - h - 8);
+    buildMaze(assets);
 
-    m_playerHpBg->setRect(pos.x(), pos.y(), w, h);
+    QStringList stages;
+    for (const auto &s : assets.stageMs)
+        stages << QString("%1 %2 ms").arg(s.first).arg(s.second, 0, 'f', 1);
+    stages << QString("hookup %1 ms").arg(hookup.nsecsElapsed() / 1e6, 0, 'f', 1);
+    qDebug().noquote() << "[GameView] Level loaded in"
+                       << m_loadClock.elapsed() << "ms:" << stages.join(", ");
 
-    qreal ratio = qMax(0.0, (double)m_playerHp / m_playerMaxHp);
-    m_playerHpFg->setRect(pos.x(), pos.y(), w * ratio, h);
 }
 
-void GameView::keyPressEvent(QKeyEvent *event)
+void GameView::startLevel()
 {
-    if (!m_player) {
-        QGraphicsView::keyPressEvent(event);
-        return;
+    qDebug() << "[GameView] Level playable after" << m_loadClock.elapsed() << "ms,"
+             << m_chunkCells.size() - m_chunksUploaded << "tile chunks still to come";
+
+    // Swap in the new level; the old scene goes away in small pieces
+    if (!m_softRendering) {
+        setScene(m_scene);
+        resetCachedContent();
+    }
+    if (m_retiredScene) {
+        retireScene(m_retiredScene);
+        m_retiredScene = nullptr;
     }
 
-    bool handled = m_controller.handleKeyPress(event);
-    if (!handled) {
-        QGraphicsView::keyPressEvent(event);
-        return;
+    if (m_loader) {
+        m_loader->hideOverlay();
     }
 
-    // If attack key (space), immediately resolve melee attack
-    if (event->key() == Qt::Key_Space) {
-        resolvePlayerAttack();
+    if (m_player) {
+        m_cameraCenter = QPointF(-1, -1);   // new scene: always recenter
+        renderInterpolated(1.0);
+        updateCamera();
+        if (m_softRendering)
+            renderSoftFrame();
     }
 
-    if (m_controller.isMoving() && !m_moveTimer.isActive())
-        m_moveTimer.start();
+    // Restart the game loop; the load time must not count as simulated time
+    resetFrameClock();
+    m_frameTimer.start();
+
+    m_isLoading = false;
 }
 
-void GameView::keyReleaseEvent(QKeyEvent *event)
+void GameView::retireScene(QGraphicsScene *scene)
 {
-    if (!m_player) {
-        QGraphicsView::keyReleaseEvent(event);
-        return;
-    }
+    PROFILE_SCOPE("retireScene");
 
-    bool handled = m_controller.handleKeyRelease(event);
-    if (!handled) {
-        QGraphicsView::keyReleaseEvent(event);
-        return;
+    // Removing items from an indexed scene updates the BSP tree each time
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    // Children go with their parents
+    QList<QGraphicsItem*> roots;
+    const QList<QGraphicsItem*> all = scene->items();
+    for (QGraphicsItem *item : all) {
+        if (!item->parentItem())
+            roots.append(item);
     }
 
-    if (!m_controller.isMoving()) {
-        m_moveTimer.stop();
+    for (int i = 0; i < roots.size(); i += kTeardownBatch) {
+        QList<QGraphicsItem*> batch = roots.mid(i, kTeardownBatch);
+        m_sceneTeardown.add([batch] { qDeleteAll(batch); });
     }
+    m_sceneTeardown.add([scene] { delete scene; });
 }
 
-void GameView::stepMovement()
+void GameView::queueTileChunks(const LevelAssets &assets)
 {
-    if (!m_player)
-        return;
+    auto shared = std::make_shared<const LevelAssets>(assets);
+
+    const auto &grid = assets.maze.grid;
+    const int rows = static_cast<int>(grid.size());
+    const int cols = static_cast<int>(grid[0].size());
+
+    // Chunks nearest to the start cell first
+    QVector<QRect> &chunks = m_chunkCells;
+    chunks.clear();
+    for (int r = 0; r < rows; r += kTileChunkCells)
+        for (int c = 0; c < cols; c += kTileChunkCells)
+            chunks.append(QRect(c, r, qMin(kTileChunkCells, cols - c),
+                                      qMin(kTileChunkCells, rows - r)));
+
+    const QPoint start(assets.maze.start.c, assets.maze.start.r);
+    auto distance = [&](const QRect &chunk) {
+        QPoint d = chunk.center() - start;
+        return d.x() * d.x() + d.y() * d.y();
+    };
+    std::sort(chunks.begin(), chunks.end(), [&](const QRect &a, const QRect &b) {
+        return distance(a) < distance(b);
+    });
 
-    QPointF delta = m_controller.movementDelta();
-    if (delta.isNull())
-        return;
+    // The level becomes playable once the chunks under the first view exist
+    const QSizeF viewCells(viewport()->width()  / qreal(m_cellSize) + 2,
+                           viewport()->height() / qreal(m_cellSize) + 2);
+    const QRectF firstView(QPointF(start.x() - viewCells.width() / 2,
+                                   start.y() - viewCells.height() / 2), viewCells);
+
+    auto underFirstView = std::stable_partition(chunks.begin(), chunks.end(),
+                                                [&](const QRect &chunk) {
+        return QRectF(chunk).intersects(firstView);
+    });
+    m_firstViewChunks  = int(underFirstView - chunks.begin());
+    m_firstViewPending = m_firstViewChunks;
+    m_chunksUploaded   = 0;
+    if (m_firstViewChunks == 0)
+        m_sceneBuilder.add([this] { startLevel(); });
+
+    // Finished chunk images are turned into pixmaps in the builder's
+    // slices, unless a newer level has been started since
+    const int generation = m_chunkGeneration;
+    auto *watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::resultReadyAt, this,
+            [this, watcher, generation](int index) {
+        if (generation != m_chunkGeneration)
+            return;
+        const QImage image = watcher->resultAt(index);
+        m_sceneBuilder.add([this, index, image, generation] {
+            if (generation == m_chunkGeneration)
+                uploadTileChunk(index, image);
+        });
+    });
+    connect(watcher, &QFutureWatcher<QImage>::finished, watcher, &QObject::deleteLater);
+    m_chunkRaster = watcher;
 
-    // Only process player movement; monster AI runs in separate timer
-    tryMovePlayer(delta);
-    updatePlayerHpBar();
+    // The pool takes chunks in this order, one per core; QPainter on a
+    // QImage is safe off the GUI thread
+    watcher->setFuture(QtConcurrent::mapped(chunks, TileChunkRasterizer{ shared, m_cellSize }));
 }
 
-bool GameView::tryMovePlayer(const QPointF &delta)
+void GameView::uploadTileChunk(int index, const QImage &image)
 {
-    if (!m_player) return false;
+    PROFILE_SCOPE("tileChunk");
 
-    QPointF oldPos = m_player->pos();
-    QPointF newPos = oldPos + delta;
+    const QRect &cells = m_chunkCells[index];
+    m_scene->addTileChunk(QPoint(cells.left() * m_cellSize, cells.top() * m_cellSize),
+                          QPixmap::fromImage(image));
 
-    m_player->setPos(newPos);
+    ++m_chunksUploaded;
+    if (index < m_firstViewChunks && --m_firstViewPending == 0)
+        startLevel();
+}
 
-    QRectF spriteLocal = m_player->boundingRect();
-    QPointF bottomCenterLocal(
-        spriteLocal.center().x(),
-        spriteLocal.bottom()
-        );
-    QPointF bottomCenterScene = m_player->mapToScene(bottomCenterLocal);
+void GameView::buildMaze(const LevelAssets &assets)
+{
+    PROFILE_SCOPE("buildMaze");
+
+    // Tile chunks of the previous level must not land in this one. Its
+    // batch is cancelled, not waited for: what it still delivers belongs
+    // to an old generation and is dropped
+    ++m_chunkGeneration;
+    if (m_chunkRaster)
+        m_chunkRaster->cancel();
+    m_sceneBuilder.clear();
+
+    // Animated items of the old scene stop here, before it goes away
+    m_animationClock.clear();
+
+    // Build into a fresh scene; the old one stays on screen until the new
+    // one is ready and is then torn down in slices (startLevel)
+    // Tiles go into its background, items stay unindexed (LevelScene)
+    LevelScene *next = new LevelScene(this);
+
+    // Monster items are kept: back to the pool and over to the new scene
+    for (MonsterItem *item : std::as_const(m_monsterItems))
+        m_monsterPool.release(item);
+    m_monsterItems.clear();
+    m_monsterPool.moveTo(next);
+    m_monsterPool.reserve(kMonsterPoolSize);
+
+    if (m_retiredScene)
+        delete m_scene;            // built but never shown: a load was restarted
+    else
+        m_retiredScene = m_scene;
+    m_scene = next;
 
-    // ---- Feet collision box ----
-    qreal hitHeight = m_cellSize * 0.6;
-    qreal hitWidth  = m_cellSize * 0.6;
+    m_player   = nullptr;
+    m_exitTile = nullptr;
+    m_doors.clear();
+    m_keys.clear();
+
+    // Pixmaps are converted once per image and shared across levels
+    AssetCache &cache = AssetCache::instance();
+    m_openDoorPix = cache.pixmap(assets.openDoorImage);
+    m_damagePix   = cache.pixmap(assets.damageMonsterImage);
+    m_slowPix     = cache.pixmap(assets.slowMonsterImage);
+    if (m_damagePix.isNull() || m_slowPix.isNull())
+        qWarning() << "[GameView] Monster textures not found under"
+                   << QCoreApplication::applicationDirPath() + "/monsters";
 
-    QRectF feetScene(
-        bottomCenterScene.x() - hitWidth / 2.0,
-        bottomCenterScene.y() - hitHeight - 13.0,
-        hitWidth,
-        hitHeight
-        );
+    if (!assets.player.isEmpty())
+        m_playerSprites = assets.player;
 
-    QPainterPath feetPath;
-    feetPath.addRect(feetScene);
+    if (m_softRendering)
+        loadSoftSprites(assets);
 
-    QList<QGraphicsItem*> items = m_scene->items(
-        feetPath,
-        Qt::IntersectsItemShape,
-        Qt::DescendingOrder,
-        QTransform()
-        );
+    if (m_openWorld)
+        beginOpenWorld(assets);
+    else
+        addMazeItems(assets);
 
-    bool blocked     = false;
-    bool reachedExit = false;
+    if (!m_openWorld) {
+        m_minimap->setLevel(assets.maze);
+        m_minimap->setVisible(m_minimapWanted);
+    }
 
-    for (QGraphicsItem *item : items) {
-        if (item == m_player) continue;
+    if (m_fovEnabled) {
+        m_fov.setLevel(assets.maze.grid);
+        m_scene->setFieldOfView(&m_fov, m_cellSize);
+        m_softRenderer.setVisibleCells(&m_fov.visible());
+    }
 
-        QVariant tag = item->data(0);
+    // Create player from the sprites decoded with the first level
+    m_player = new PlayerItem(m_playerSprites);
+    m_player->setClock(&m_animationClock);
+    m_scene->addItem(m_player);
 
-        if (tag == "wall") {
-            blocked = true;
-        } else if (tag == "door") {
-            bool unlocked = item->data(1).toBool();
-            if (!unlocked) blocked = true;
-        } else if (tag == "key") {
-            int doorIndex = item->data(1).toInt();
+    m_hudBars.clear();
 
-            if (doorIndex >= 0 && doorIndex < static_cast<int>(m_doors.size())) {
+    // Level boundaries are part of the input log
+    m_recorder.beginLevel();
+    if (m_replay.isOpen() && !m_replay.takeLevelStart())
+        finishReplay();
 
-                QGraphicsPixmapItem *door = m_doors[doorIndex];
-                door->setData(1, true);  // unlocked
+    // Player is placed from the simulation's start position when rendered
+    m_input.reset();
 
-                QString base = QCoreApplication::applicationDirPath();
-                QString openPath = base + "/texture/doors/open/dngn_open_door.png";
-                QPixmap openTex(openPath);
+    // Floor and wall tiles are rasterized on the thread pool
+    if (!m_openWorld)
+        queueTileChunks(assets);
+}
 
-                if (!openTex.isNull()) {
-                    openTex = openTex.scaled(
-                        door->boundingRect().width(),
-                        door->boundingRect().height(),
-                        Qt::KeepAspectRatioByExpanding,
-                        Qt::SmoothTransformation
-                        );
-                    door->setPixmap(openTex);
-                }
-            }
+void GameView::addMazeItems(const LevelAssets &assets)
+{
+    AssetCache &cache = AssetCache::instance();
+
+    // Maze data (grid + start + exit + doors + keys) from the loader
+    const MazeGenerator::MazeData &maze = assets.maze;
 
-            spawnMonsters(4);
-            m_scene->removeItem(item);
-            delete item;
-        } else if (tag == "exit") {
-            reachedExit = true;
+    // All gameplay (collision, keys, monsters) runs on the maze data
+    m_sim.loadLevel(maze);
+
+    const auto &grid = maze.grid;
+    int gridRows = static_cast<int>(grid.size());
+    int gridCols = static_cast<int>(grid[0].size());
+
+    // Scene size in pixels
+    int sceneWidth  = gridCols * m_cellSize;
+    int sceneHeight = gridRows * m_cellSize;
+    m_scene->setSceneRect(0, 0, sceneWidth, sceneHeight);
+
+    // Draw EXIT (2x2 block)
+    {
+        int exitX = maze.exit.c * m_cellSize;
+        int exitY = maze.exit.r * m_cellSize;
+
+        if (!assets.exitImage.isNull()) {
+            auto *exitItem = m_scene->addPixmap(cache.pixmap(assets.exitImage));
+            exitItem->setPos(exitX, exitY);
+            exitItem->setData(0, "exit");
+            exitItem->setZValue(-0.5);
+
+            m_exitTile = exitItem;
         }
     }
 
-    if (blocked) {
-        m_player->setPos(oldPos);
-        return false;
+    // Draw doors
+    const QPixmap scaledDoor = cache.pixmap(assets.doorImage);
+    for (int i = 0; i < static_cast<int>(maze.doors.size()); ++i) {
+        MazeGenerator::Cell d = maze.doors[i];
+        int doorX = d.c * m_cellSize;
+        int doorY = d.r * m_cellSize;
+
+        auto *doorItem = m_scene->addPixmap(scaledDoor);
+        doorItem->setPos(doorX, doorY);
+        doorItem->setData(0, "door");
+        doorItem->setData(1, false);   // locked
+        doorItem->setZValue(0);
+        m_doors.push_back(doorItem);
     }
 
-    centerOn(m_player);
+    // Draw keys
+    m_keys.assign(maze.keys.size(), nullptr);
+    const QPixmap scaledKey = cache.pixmap(assets.keyImage);
+    for (int i = 0; i < static_cast<int>(maze.keys.size()); ++i) {
+        MazeGenerator::Cell k = maze.keys[i];
+        if (!scaledKey.isNull())
+        {
+            int keyX = k.c * m_cellSize + (m_cellSize - scaledKey.width()) / 2;
+            int keyY = k.r * m_cellSize + (m_cellSize - scaledKey.height()) / 2;
 
-    if (reachedExit) {
-        for (MonsterItem *m : m_monsters) {
-            if (m) {
-                m_scene->removeItem(m);
-                delete m;
-            }
+            auto *keyItem = m_scene->addPixmap(scaledKey);
+            keyItem->setPos(keyX, keyY);
+            keyItem->setData(0, "key");
+            keyItem->setData(1, i);       // door index
+            keyItem->setZValue(1);
+            m_keys[i] = keyItem;
         }
-        m_monsters.clear();
-
-        loadNextLevel();
-        viewport()->update();
     }
-
-    return true;
 }
 
-void GameView::spawnMonsters(int count)
+void GameView::beginOpenWorld(const LevelAssets &assets)
 {
-    if (m_walkableCells.isEmpty())
-        return;
+    // The player starts on the first passage of chunk (0, 0)
+    const MazeGenerator::Cell start { 2, 2 };
+    m_sim.loadOpenWorld(assets.maze.seed, start);
 
-    QString base = QCoreApplication::applicationDirPath();
+    m_chunkCells.clear();
+    m_chunksUploaded = 0;
 
-    // Two kinds of monster textures
-    QPixmap damagePix(base + "/monsters/damage.png"); // Damage monster
-    QPixmap slowPix(base + "/monsters/slow.png");     // Slow monster
+    // The level starts once the chunks around the player are in
+    m_world.reset(assets, assets.maze.seed, m_cellSize);
+    m_world.setFocus(WorldStreamer::chunkOf(start.r, start.c));
+    refreshWorldWindow();
+}
 
-    if (damagePix.isNull() || slowPix.isNull()) {
-        qWarning() << "[GameView] Monster textures not found under"
-                   << base + "/monsters";
-    }
+void GameView::updateWorldFocus()
+{
+    const QPoint cell  = playerCell();
+    const QPoint chunk = WorldStreamer::chunkOf(cell.y(), cell.x());
+    if (chunk == m_world.focus())
+        return;
 
-    for (int i = 0; i < count; ++i) {
-        int idx = QRandomGenerator::global()->bounded(m_walkableCells.size());
-        QPoint cell = m_walkableCells[idx];
+    m_world.setFocus(chunk);
+    refreshWorldWindow();
+}
 
-        QPointF center(cell.x() * m_cellSize + m_cellSize / 2.0,
-                       cell.y() * m_cellSize + m_cellSize / 2.0);
+void GameView::refreshWorldWindow()
+{
+    PROFILE_SCOPE("worldWindow");
+
+    const int r    = WorldStreamer::kKeepRadius;
+    const int span = (2 * r + 1) * WorldStreamer::kChunkCells;
+    const QPoint origin = (m_world.focus() - QPoint(r, r)) * WorldStreamer::kChunkCells;
+
+    std::vector<std::vector<int>> grid(span, std::vector<int>(span));
+    for (int row = 0; row < span; ++row)
+        for (int col = 0; col < span; ++col)
+            grid[row][col] = m_world.cell(origin.y() + row, origin.x() + col);
+    m_sim.setGridWindow(origin, std::move(grid));
+
+    // The view scrolls within the window; recenter against the new bounds
+    m_scene->setSceneRect(origin.x() * m_cellSize, origin.y() * m_cellSize,
+                          span * m_cellSize, span * m_cellSize);
+    m_cameraCenter = QPointF(-1, -1);
+    if (m_player)
+        updateCamera();
+}
 
-        int r = QRandomGenerator::global()->bounded(100);
-        MonsterItem::MonsterType t =
-            (r < 30 ? MonsterItem::DamageMonster   // 30% damage monster
-                    : MonsterItem::SlowMonster);    // 70% slow monster
+void GameView::onWorldChunkReady(const QPoint &chunk)
+{
+    PROFILE_SCOPE("tileChunk");
 
-        const QPixmap &pix = (t == MonsterItem::DamageMonster ? damagePix : slowPix);
-        if (pix.isNull())
-            continue;
+    const int size = WorldStreamer::kChunkCells * m_cellSize;
+    m_scene->addTileChunk(chunk * size, QPixmap::fromImage(m_world.takeImage(chunk)));
 
-        MonsterItem *monster = new MonsterItem(t, pix, 100, m_cellSize);
-        m_scene->addItem(monster);
+    const QPoint d = chunk - m_world.focus();
+    if (qAbs(d.x()) <= WorldStreamer::kKeepRadius && qAbs(d.y()) <= WorldStreamer::kKeepRadius)
+        refreshWorldWindow();
 
-        QRectF b = monster->boundingRect();
-        monster->setPos(center.x() - b.width() / 2.0,
-                        center.y() - b.height() / 2.0);
+    if (m_isLoading && m_player && m_world.isFocusReady())
+        startLevel();
+}
 
-        m_monsters.append(monster);
-    }
+void GameView::onWorldChunkEvicted(const QPoint &chunk)
+{
+    m_scene->removeTileChunk(chunk * (WorldStreamer::kChunkCells * m_cellSize));
 }
 
-void GameView::updateMonsters()
+void GameView::updateHud()
 {
-    if (!m_player || m_monsters.isEmpty())
+    if (!m_player)
         return;
 
-    QRectF pb = m_player->boundingRect();
-    QPointF playerCenter = m_player->pos() + QPointF(pb.width() / 2.0,
-                                                     pb.height());
-
-    qreal attackRadius = m_cellSize * 1.0;
+    PROFILE_SCOPE("hud");
 
-    // 30ms * 15 ≈ 450ms ≈ 0.5s per attack
-    const int ticksPerHit = 15;
+    m_nextHudBars.clear();
 
-    for (int i = m_monsters.size() - 1; i >= 0; --i) {
-        MonsterItem* m = m_monsters[i];
-        if (!m) continue;
+    // Player: above the head
+    {
+        const QRectF pb = m_player->sceneBoundingRect();
+        const qreal w = m_cellSize * 1.0;
+        const qreal h = 6.0;
+        const qreal ratio = qMax(0.0, (double)m_sim.playerHp() / m_sim.playerMaxHp());
+        m_nextHudBars.push_back({ QRectF(pb.center().x() - w / 2.0, pb.top() - h - 8, w, h),
+                                  ratio });
+    }
 
-        if (m->isDead()) {
-            m_scene->removeItem(m);
-            delete m;
-            m_lastAttackTick.remove(m);
-            m_touchingMonsters.remove(m);
-            m_monsters.removeAt(i);
+    // Monsters: a thinner bar just above the sprite
+    for (const GameSimulation::Monster &m : m_sim.monsters()) {
+        MonsterItem *item = m_monsterItems.value(m.id);
+        if (!item || !item->isVisible())
             continue;
-        }
-
-        QRectF mb = m->boundingRect();
-        QPointF monsterCenter = m->pos() + QPointF(mb.width()/2.0,
-                                                   mb.height());
 
-        QLineF line(monsterCenter, playerCenter);
-        qreal dist = line.length();
-
-        bool touching = (dist <= attackRadius);
+        const QRectF mb = item->sceneBoundingRect();
+        const qreal w = m_cellSize;
+        const qreal h = 4.0;
+        const qreal ratio = (m.maxHp > 0) ? qMax(0.0, (double)m.hp / m.maxHp) : 0.0;
+        m_nextHudBars.push_back({ QRectF(mb.center().x() - w / 2.0, mb.top() - h - 2, w, h),
+                                  ratio });
+    }
 
-        // ---- Attack: when touching, damage approx every 0.5s ----
-        if (touching) {
-            int lastTick = m_lastAttackTick.value(m, -1000000);
-            if (m_tickCount - lastTick >= ticksPerHit) {
-                if (m->monsterType() == MonsterItem::DamageMonster)
-                    damagePlayer(10);
-                else
-                    applySlowToPlayer(1500, 0.5);  // 1.5s slow to 50%
+    // Repaint where a bar was or now is; nothing in the scene changes
+    auto repaint = [this](const QRectF &r) {
+        viewport()->update(mapFromScene(r).boundingRect().adjusted(-1, -1, 1, 1));
+    };
+    const std::size_t n = qMax(m_hudBars.size(), m_nextHudBars.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        const HudBar *was = i < m_hudBars.size()     ? &m_hudBars[i]     : nullptr;
+        const HudBar *now = i < m_nextHudBars.size() ? &m_nextHudBars[i] : nullptr;
+        if (was && now && was->rect == now->rect && was->ratio == now->ratio)
+            continue;
+        if (was)
+            repaint(was->rect);
+        if (now)
+            repaint(now->rect);
+    }
 
-                m_lastAttackTick[m] = m_tickCount;
-            }
+    m_hudBars.swap(m_nextHudBars);
+}
 
-            m_touchingMonsters.insert(m);
-            // When touching, monster stays still or moves minimally; do not chase
+void GameView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    for (const HudBar &bar : m_hudBars) {
+        if (!rect.intersects(bar.rect))
             continue;
-        } else {
-            // Leaving contact resets cooldown
-            m_touchingMonsters.remove(m);
-        }
+        painter->fillRect(bar.rect, Qt::red);
+        painter->fillRect(QRectF(bar.rect.topLeft(),
+                                 QSizeF(bar.rect.width() * bar.ratio, bar.rect.height())),
+                          Qt::green);
+    }
+}
 
-        // ---- Random decision: chase player or wander ----
-        bool chase = (QRandomGenerator::global()->bounded(100) < 85);
+void GameView::setupSoftRenderer(const LaunchOptions &options)
+{
+    if (options.renderer != "soft") {
+        if (options.renderer != "scene")
+            qWarning() << "[GameView] Unknown renderer" << options.renderer;
+        return;
+    }
+    if (m_openWorld) {
+        qWarning() << "[GameView] The soft renderer needs a fixed level; using the scene";
+        return;
+    }
 
-        QPointF delta(0, 0);
-        qreal step = m->speed();
+    QImage::Format format = (options.framebufferFormat == "xrgb8888")
+                                ? QImage::Format_RGB32 : QImage::Format_RGB16;
+    if (!options.framebuffer.isEmpty()) {
+        QString error;
+        if (m_framebuffer.open(options.framebuffer, maximumViewportSize(), format, &error))
+            format = m_framebuffer.format();
+        else
+            qWarning() << "[GameView] Framebuffer output disabled:" << error;
+    }
 
-        if (chase && dist > 0.1) {
-            // Normal chase
-            line.setLength(step);
-            delta = QPointF(line.dx(), line.dy());
-        } else {
-            // Random direction
-            int angleDeg = QRandomGenerator::global()->bounded(360);
-            qreal rad = angleDeg * (3.14159265 / 180.0);
-            delta = QPointF(std::cos(rad) * step,
-                            std::sin(rad) * step);
-        }
+    m_softRendering = true;
+    m_softRenderer.setTarget(maximumViewportSize(), format);
+    m_softEntities.reserve(64);
+    m_softBars.reserve(32);
+    qDebug() << "[GameView] Soft renderer,"
+             << (format == QImage::Format_RGB16 ? "RGB565" : "XRGB8888")
+             << (m_framebuffer.isOpen() ? "to " + options.framebuffer : QString("to window"));
+}
 
-        // ---- Small noisy jitter (to avoid synchronized movement) ----
-        qreal noiseX = (QRandomGenerator::global()->bounded(100) - 50) / 200.0;
-        qreal noiseY = (QRandomGenerator::global()->bounded(100) - 50) / 200.0;
-        delta += QPointF(noiseX, noiseY);
+void GameView::loadSoftSprites(const LevelAssets &assets)
+{
+    // A missing open-door image keeps the closed one, as the scene does
+    QVector<QImage> images = {
+        assets.exitImage, assets.doorImage,
+        assets.openDoorImage.isNull() ? assets.doorImage : assets.openDoorImage,
+        assets.keyImage, assets.damageMonsterImage, assets.slowMonsterImage
+    };
+    m_softSprites.exit          = 0;
+    m_softSprites.door          = 1;
+    m_softSprites.openDoor      = 2;
+    m_softSprites.key           = 3;
+    m_softSprites.damageMonster = 4;
+    m_softSprites.slowMonster   = 5;
+
+    for (int i = 0; i < PlayerPose::kSlots; ++i) {
+        const QVector<QImage> &frames = m_playerSprites.animations[i].frames;
+        m_softSprites.player[i] = frames.isEmpty() ? -1 : images.size();
+        images += frames;
+    }
 
-        // ---- Repulsion (prevent crowding) ----
-        for (MonsterItem* other : m_monsters) {
-            if (other == m) continue;
+    m_softRenderer.setSprites(images);
+    m_softRenderer.setLevel(assets, m_cellSize);
+}
 
-            QRectF ob = other->boundingRect();
-            QPointF otherCenter = other->pos() + QPointF(ob.width()/2.0,
-                                                         ob.height()/2.0);
+void GameView::renderSoftFrame()
+{
+    const SoftSprites &s = m_softSprites;
+
+    // Same stacking as the scene's z values
+    m_softEntities.clear();
+    if (m_exitTile && m_exitTile->isVisible())
+        m_softEntities.push_back({ s.exit, m_exitTile->pos().toPoint() });
+
+    const QVector<GameSimulation::Door> &doors = m_sim.doors();
+    for (std::size_t i = 0; i < m_doors.size() && int(i) < doors.size(); ++i) {
+        if (m_doors[i]->isVisible())
+            m_softEntities.push_back({ doors[int(i)].open ? s.openDoor : s.door,
+                                       m_doors[i]->pos().toPoint() });
+    }
 
-            qreal d = QLineF(monsterCenter, otherCenter).length();
-            if (d < (m_cellSize * 1.1) && d > 0.01) {
-                QPointF diff = monsterCenter - otherCenter;
-                diff /= d;
-                delta += diff * 0.4;   // strength of repulsion
-            }
-        }
+    const int base = s.player[m_player->animationSlot()];
+    if (base >= 0)
+        m_softEntities.push_back({ base + m_player->frameIndex(), m_player->pos().toPoint() });
 
-        m->setPos(m->pos() + delta);
+    for (const GameSimulation::Monster &m : m_sim.monsters()) {
+        MonsterItem *item = m_monsterItems.value(m.id);
+        if (item && item->isVisible())
+            m_softEntities.push_back({ m.kind == GameSimulation::DamageMonster
+                                           ? s.damageMonster : s.slowMonster,
+                                       item->pos().toPoint() });
     }
 
-    // Remove attack records of monsters that no longer exist
-    for (auto it = m_lastAttackTick.begin(); it != m_lastAttackTick.end(); ) {
-        if (!m_monsters.contains(it.key()))
-            it = m_lastAttackTick.erase(it);
-        else
-            ++it;
+    for (QGraphicsPixmapItem *key : m_keys) {
+        if (key && key->isVisible())
+            m_softEntities.push_back({ s.key, key->pos().toPoint() });
     }
-}
 
-void GameView::damagePlayer(int amount)
-{
-    m_playerHp -= amount;
-    if (m_playerHp < 0)
-        m_playerHp = 0;
+    m_softBars.clear();
+    for (const HudBar &bar : m_hudBars)
+        m_softBars.push_back({ bar.rect.toRect(), bar.ratio });
 
-    qDebug() << "[GameView] Player HP:" << m_playerHp << "/" << m_playerMaxHp;
+    m_softRenderer.render(m_softCamera, m_softEntities, m_softBars);
 
-    if (m_playerHp <= 0) {
-        // Simple handling: stop movement & play death action
-        m_moveTimer.stop();
-        m_monsterAITimer.stop();
-        m_controller.setStep(0);
-        m_player->setAction(PlayerItem::Dying);
-        QTimer::singleShot(6000, this, [](){
-            QApplication::quit();  // Quit whole program
-        });
+    if (m_framebuffer.isOpen()) {
+        m_framebuffer.present(m_softRenderer.frame());
+        recordFramePresented();
+    } else {
+        viewport()->update();
     }
 }
 
-void GameView::applySlowToPlayer(int durationMs, qreal factor)
+void GameView::recordFramePresented()
 {
-    if (m_playerSlowed)
-        return;
-
-    m_playerSlowed = true;
-
-    int originalStep = m_step;
-    int slowedStep   = qMax(1, int(originalStep * factor));
-    m_controller.setStep(slowedStep);
-
-    // Restore speed after duration
-    QTimer::singleShot(durationMs, this, [this, originalStep]() {
-        m_controller.setStep(originalStep);
-        m_playerSlowed = false;
-    });
+    if (m_latencyPendingNs) {
+        m_inputLatency.record(inputClockNs() - m_latencyPendingNs);
+        m_latencyPendingNs = 0;
+    }
 }
 
-void GameView::resolvePlayerAttack()
+void GameView::keyPressEvent(QKeyEvent *event)
 {
-    if (!m_player)
+    // Debug keys work in every control mode
+    if (event->key() == Qt::Key_F3 && !event->isAutoRepeat()) {
+        m_debugOverlay->toggle();
         return;
+    }
+    if (event->key() == Qt::Key_F4 && !event->isAutoRepeat()) {
+        dumpTrace();
+        return;
+    }
+    if (event->key() == Qt::Key_F5 && !event->isAutoRepeat()) {
+        dumpLatency();
+        return;
+    }
+    if (event->key() == Qt::Key_M && !event->isAutoRepeat() && !m_openWorld) {
+        m_minimapWanted = !m_minimapWanted;
+        m_minimap->setVisible(m_minimapWanted);
+        return;
+    }
 
-    QRectF spriteLocal = m_player->boundingRect();
-    QPointF bottomCenterLocal(
-        spriteLocal.center().x(),
-        spriteLocal.bottom()
-        );
-    QPointF bottomCenterScene = m_player->mapToScene(bottomCenterLocal);
-
-    QRectF attackRect;
-    qreal w = m_cellSize;
-    qreal h = m_cellSize;
-
-    switch (m_player->direction()) {
-    case PlayerItem::Front:
-        attackRect = QRectF(bottomCenterScene.x() - w/2.0,
-                            bottomCenterScene.y(),
-                            w, h);
-        break;
-    case PlayerItem::Back:
-        attackRect = QRectF(bottomCenterScene.x() - w/2.0,
-                            bottomCenterScene.y() - h,
-                            w, h);
-        break;
-    case PlayerItem::Left:
-        attackRect = QRectF(bottomCenterScene.x() - w,
-                            bottomCenterScene.y() - h/2.0,
-                            w, h);
-        break;
-    case PlayerItem::Right:
-        attackRect = QRectF(bottomCenterScene.x(),
-                            bottomCenterScene.y() - h/2.0,
-                            w, h);
-        break;
-    }
-
-    QPainterPath path;
-    path.addRect(attackRect);
-
-    QList<QGraphicsItem*> items = m_scene->items(
-        path,
-        Qt::IntersectsItemShape,
-        Qt::DescendingOrder,
-        QTransform()
-        );
-
-    // Attack only the closest monster
-    MonsterItem* closest = nullptr;
-    qreal bestDist = 1e9;
-
-    QPointF playerCenter = m_player->mapToScene(spriteLocal.center());
-
-    for (QGraphicsItem *item : items) {
-        auto *monster = dynamic_cast<MonsterItem*>(item);
-        if (monster) {
-            QRectF mb = monster->boundingRect();
-            QPointF mc = monster->pos() + QPointF(mb.width()/2.0, mb.height()/2.0);
-
-            qreal d = QLineF(playerCenter, mc).length();
-            if (d < bestDist) {
-                bestDist = d;
-                closest = monster;
-            }
-        }
+    if (!m_player) {
+        QGraphicsView::keyPressEvent(event);
+        return;
     }
 
-    if (closest) {
-        closest->takeDamage(40);
+    bool handled = m_input.handleKeyPress(event);
+    if (!handled) {
+        QGraphicsView::keyPressEvent(event);
+        return;
     }
 }
 
-// ---- Monster collision check: is the target position a wall? ----
-bool GameView::monsterCanMoveTo(const QPointF &pos)
+void GameView::keyReleaseEvent(QKeyEvent *event)
 {
-    if (m_grid.empty())
-        return false;
+    if (!m_player) {
+        QGraphicsView::keyReleaseEvent(event);
+        return;
+    }
 
-    int col = static_cast<int>(pos.x() / m_cellSize);
-    int row = static_cast<int>(pos.y() / m_cellSize);
+    bool handled = m_input.handleKeyRelease(event);
+    if (!handled) {
+        QGraphicsView::keyReleaseEvent(event);
+        return;
+    }
+}
 
-    if (row < 0 || col < 0)
-        return false;
+void GameView::paintEvent(QPaintEvent *event)
+{
+    {
+        PROFILE_SCOPE("paint");
+        if (m_softRendering) {
+            QPainter painter(viewport());
+            painter.drawImage(0, 0, m_softRenderer.frame());
+        } else {
+            QGraphicsView::paintEvent(event);
+        }
+    }
 
-    int rows = static_cast<int>(m_grid.size());
-    int cols = static_cast<int>(m_grid[0].size());
+    recordFramePresented();
+}
 
-    if (row >= rows || col >= cols)
-        return false;
+void GameView::dumpTrace()
+{
+    QString path = QCoreApplication::applicationDirPath()
+                   + QString("/trace-%1.json")
+                         .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+
+    if (FrameProfiler::instance().writeChromeTrace(path))
+        qDebug() << "[GameView] Trace written to" << path;
+    else
+        qWarning() << "[GameView] Could not write trace to" << path;
+}
 
-    // 1 means wall; non-wall is walkable
-    return (m_grid[row][col] != 1);
+void GameView::dumpLatency()
+{
+    QString path = QCoreApplication::applicationDirPath()
+                   + QString("/latency-%1.csv")
+                         .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+
+    if (m_inputLatency.writeCsv(path))
+        qDebug() << "[GameView] Input latency written to" << path;
+    else
+        qWarning() << "[GameView] Could not write input latency to" << path;
 }
 
 void GameView::resizeEvent(QResizeEvent *event)
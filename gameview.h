@@ -5,125 +5,242 @@
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QImage>
 #include <QPixmap>
 #include <QBrush>
 #include <vector>
 #include <QVector>
 #include <QPoint>
-#include <QFutureWatcher>
 #include <QSet>
 #include <QHash>
 
 #include "mazegenerator.h"
+#include "gamesimulation.h"
 #include "monsteritem.h"
 #include "playeritem.h"
-#include "playercontroller.h"
-#include "gpiocontroller.h"
+#include "animationclock.h"
 #include "textures.h"
+#include "tilelayer.h"
+#include "softrenderer.h"
+#include "worldstreamer.h"
+#include "framebuffersink.h"
 #include "loadingoverlay.h"
+#include "debugoverlay.h"
+#include "minimap.h"
+#include "fieldofview.h"
+#include "inputhub.h"
+#include "inputlog.h"
+#include "levelloader.h"
+#include "scenebuilder.h"
+#include "latencyhistogram.h"
+#include "launchoptions.h"
 
 class QKeyEvent;
+class QPaintEvent;
 class QResizeEvent;
 
-#define KEY     1
-#define GPIO    2
-#define CONTROL GPIO
-
-struct WallStyle {
-    QString prefix;   // e.g. "brick_brown" or "stone_brick"
-    int count;        // number of numbered variants: 0..count-1
-};
-
-struct FloorStyle {
-    QString prefix;   // e.g. "brick_brown" or "stone_brick"
-    int count;        // number of numbered variants: 0..count-1
-};
-
 class GameView : public QGraphicsView
 {
     Q_OBJECT
 
 public:
     explicit GameView(const QString &characterName = "Assassin",
+                      const LaunchOptions &options = LaunchOptions(),
                       QWidget *parent = nullptr);
+    ~GameView() override;
 
     void loadNextLevel();
 
+    static constexpr int kCellSize = 32;
+
+    // Images a game with any of these characters may need for its first
+    // level; see AssetCache::preload. Any thread
+    static QVector<AssetRequest> warmUpRequests(const QStringList &characterNames);
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
 
 private slots:
-    void stepMovement();  // Player movement timer callback (≈60 FPS)
-    void finishLoadNextLevel();
+    void frameTick();     // Game loop: runs fixed simulation steps, then renders
+    void finishLoadNextLevel(const LevelAssets &assets);
 
 private:
-    void buildMaze();
-    bool tryMovePlayer(const QPointF &delta); // movement + collision handling
-
-    QGraphicsScene       *m_scene;
+    // Fixed simulation step (seconds) and the longest frame we will catch up on
+    static constexpr qreal kSimStep      = GameSimulation::kTickSeconds;
+    static constexpr qreal kMaxFrameTime = 0.25;
+
+    // Tiles are rasterized per square chunk on the thread pool and
+    // uploaded a few chunks per event-loop turn
+    static constexpr int    kTileChunkCells   = 8;
+    static constexpr double kSceneSliceBudget = 4.0;   // ms
+    static constexpr int    kTeardownBatch    = 64;    // items per job
+
+    // Monster items created up front; a key pickup spawns a wave of 4
+    static constexpr int kMonsterPoolSize = 16;
+
+    static QString spriteRoot(const QString &characterName);
+
+    void buildMaze(const LevelAssets &assets);   // GUI-thread scene hookup
+    void addMazeItems(const LevelAssets &assets);   // sim level, exit, doors, keys
+    void queueTileChunks(const LevelAssets &assets);
+    void uploadTileChunk(int index, const QImage &image);
+    void startLevel();                           // first view is built
+    void retireScene(QGraphicsScene *scene);     // delete in slices
+    void stepMovement();                      // One fixed simulation tick
+    void handleSimEvents();                   // Mirror sim changes into the scene
+    void syncPlayerAnimation();
+    // Whole-pixel camera on the player; scrolls only when that changes
+    QPointF m_cameraCenter;
+    void    updateCamera();
+
+    void renderInterpolated(qreal alpha);     // Blend previous/current sim state
+    QRectF visibleSceneRect() const;
+    void resetFrameClock();
+
+    LevelScene           *m_scene;
     PlayerItem           *m_player;
     QGraphicsPixmapItem  *m_exitTile;
 
     std::vector<QGraphicsPixmapItem*> m_doors;
+    std::vector<QGraphicsPixmapItem*> m_keys;   // indexed like the sim's keys
 
     QString m_characterName;
 
-    int m_step;
     int m_cellSize;
     int m_rowsCells;
     int m_colsCells;
 
-    TextureSet m_wallSet;
-    TextureSet m_floorSet;
+    // Swapped in on events; from the level's assets
+    QPixmap m_openDoorPix;
+    QPixmap m_damagePix;
+    QPixmap m_slowPix;
 
     LoadingOverlay *m_loader;
     bool m_isLoading = false;
 
-    // Player movement timer (~60 FPS)
-    QTimer m_moveTimer;
-
-    // Previously used async maze generator watcher (unused now but kept)
-    QFutureWatcher<MazeGenerator::MazeData> m_mazeWatcher;
-
-    QSet<MonsterItem*> m_touchingMonsters;
-    QHash<MonsterItem*, int> m_lastAttackTick;
-
-    // ===== Newly added monster / player status variables =====
-    QVector<QPoint>     m_walkableCells;   // All walkable tiles (used for monster spawning)
-    QList<MonsterItem*> m_monsters;        // Monsters currently in the scene
-
-    bool m_monstersSpawned = false;        // Whether monsters were spawned for this level
-    int  m_playerMaxHp     = 300;
-    int  m_playerHp        = 300;
-    bool m_playerSlowed    = false;
-    int  m_tickCount       = 0;            // Tick counter (controls attack timing)
-
-    // ---- Player HP bar ----
-    QGraphicsRectItem *m_playerHpBg = nullptr;
-    QGraphicsRectItem *m_playerHpFg = nullptr;
-
-    // ---- Monster AI timer (independent of player input) ----
-    QTimer m_monsterAITimer;
-
-    // Saved maze grid (for monster collision: 1 = wall)
-    std::vector<std::vector<int>> m_grid;
-
-    // Internal helper functions
-    void spawnMonsters(int count = 3);                     // Spawn monsters
-    void updateMonsters();                                 // Monster AI & attacks
-    void resolvePlayerAttack();                            // Player attack on SPACE
-    void damagePlayer(int amount);                         // Reduce player HP
-    void applySlowToPlayer(int durationMs, qreal factor);  // Apply slow effect
-    void updatePlayerHpBar();                              // Update player HP bar position + size
-    bool monsterCanMoveTo(const QPointF &pos);             // Can monsters move to this tile?
-
-#if CONTROL==GPIO
-    GpioController m_controller;
-#else
-    PlayerController m_controller;
-#endif
+    // Generation, decoding and tile baking run on the thread pool
+    LevelLoader   m_levelLoader;
+    QElapsedTimer m_loadClock;
+    PlayerSprites m_playerSprites;   // decoded with the first level
+    SceneBuilder  m_sceneBuilder;
+
+    // Chunk images of the level being built, in upload order; the first
+    // m_firstViewChunks are under the first view and start the level.
+    // Each batch has its own watcher; results of older generations are
+    // dropped instead of waited for
+    QPointer<QFutureWatcher<QImage>> m_chunkRaster;
+    int                    m_chunkGeneration  = 0;
+    QVector<QRect>         m_chunkCells;
+    int                    m_firstViewChunks  = 0;
+    int                    m_firstViewPending = 0;
+    int                    m_chunksUploaded   = 0;
+
+    // Double-buffered levels: the next one is built off screen while the
+    // current scene is shown, then the old one is deleted bit by bit
+    QGraphicsScene *m_retiredScene = nullptr;
+    SceneBuilder    m_sceneTeardown;
+
+    // Line of sight from the player's feet cell (--fov): unseen tiles,
+    // props and monsters are not drawn; recomputed when the player changes
+    // cell
+    bool        m_fovEnabled = false;
+    FieldOfView m_fov;
+    void        updateFieldOfView();
+    bool        isInSight(const QGraphicsItem *item) const;   // any cell of it
+
+    // Explored part of the level in a corner (M toggles); not in open worlds
+    Minimap *m_minimap = nullptr;
+    bool     m_minimapWanted = true;
+    QPoint   playerCell() const;   // grid cell of the player's feet
+
+    // Frame-time graph / phase timings (F3 toggles, F4 dumps a trace)
+    DebugOverlay *m_debugOverlay = nullptr;
+    void dumpTrace();
+
+    // Input capture -> first paint showing its effect (F5 dumps it)
+    LatencyHistogram m_inputLatency;
+    qint64           m_latencyPendingNs = 0;   // oldest unpainted input
+    void dumpLatency();
+
+    // Single game loop: one timer drives input, simulation and rendering
+    QTimer        m_frameTimer;
+    QElapsedTimer m_frameClock;
+    qint64        m_lastFrameNs = 0;
+    qreal         m_accumulator = 0.0;
+
+    // Advances every animated item once per frame, on the frame clock
+    AnimationClock m_animationClock;
+
+    // All gameplay state; this view only renders it
+    GameSimulation m_sim;
+
+    // Deterministic repro: record live input, or drive the sim from a log
+    InputRecorder m_recorder;
+    InputReplay   m_replay;
+    InputState    nextInput(qint64 *captureNs);
+    void          finishRecording();
+    void          finishReplay();
+
+    // Monster visuals, keyed by simulation monster id; items come from
+    // and go back to the pool, which moves along with every new scene
+    QHash<int, MonsterItem*> m_monsterItems;
+    MonsterPool              m_monsterPool;
+
+    // ---- HUD: health bars, drawn over the scene in drawForeground ----
+    struct HudBar {
+        QRectF rect;    // scene coordinates
+        qreal  ratio;   // filled part, 0..1
+    };
+    std::vector<HudBar> m_hudBars;       // as last painted
+    std::vector<HudBar> m_nextHudBars;   // reused each frame
+
+    void updateHud();   // bars from the simulation; repaints only what moved
+
+    // ---- Open world (--open-world): one endless maze streamed in chunks
+    // around the player; the simulation sees the chunks around its focus ----
+    bool          m_openWorld = false;
+    WorldStreamer m_world;
+
+    void beginOpenWorld(const LevelAssets &assets);
+    void updateWorldFocus();     // follows the player from chunk to chunk
+    void refreshWorldWindow();   // sim grid and scene rect around the focus
+    void onWorldChunkReady(const QPoint &chunk);
+    void onWorldChunkEvicted(const QPoint &chunk);
+
+    // ---- Soft renderer (--renderer soft, --fb): the view shows no scene;
+    // each frame is composed from the tile grid, a sprite atlas and an
+    // entity list into one image, painted or written to a framebuffer ----
+    bool            m_softRendering = false;
+    SoftRenderer    m_softRenderer;
+    FramebufferSink m_framebuffer;
+    QPoint          m_softCamera;                        // frame top-left
+    std::vector<SoftRenderer::Entity> m_softEntities;    // reused each frame
+    std::vector<SoftRenderer::Bar>    m_softBars;
+
+    // Sprite atlas ids of the level's images
+    struct SoftSprites {
+        int exit = -1, door = -1, openDoor = -1, key = -1;
+        int damageMonster = -1, slowMonster = -1;
+        int player[PlayerPose::kSlots];   // first frame of each animation
+    };
+    SoftSprites m_softSprites;
+
+    void setupSoftRenderer(const LaunchOptions &options);
+    void loadSoftSprites(const LevelAssets &assets);
+    void renderSoftFrame();
+    void recordFramePresented();   // input latency ends here
+
+    // Keyboard, GPIO and replay backends merged into one event queue;
+    // declared last so backends stop before anything they feed
+    InputHub m_input;
+    void     createInputBackends(const LaunchOptions &options);
 };
 
 #endif // GAMEVIEW_H
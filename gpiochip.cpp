@@ -0,0 +1,142 @@
+#include "gpiochip.h"
+
+#include <QFile>
+#include <QDebug>
+
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+int systemIoctl(int fd, unsigned long request, void *arg)
+{
+    return ::ioctl(fd, request, arg);
+}
+
+ssize_t systemRead(int fd, void *buf, size_t count)
+{
+    return ::read(fd, buf, count);
+}
+
+GpioChip::IoctlFn s_ioctl = systemIoctl;
+GpioChip::ReadFn  s_read  = systemRead;
+
+} // namespace
+
+void GpioChip::setIoctl(IoctlFn fn)
+{
+    s_ioctl = fn ? fn : systemIoctl;
+}
+
+void GpioChip::setRead(ReadFn fn)
+{
+    s_read = fn ? fn : systemRead;
+}
+
+GpioChip::~GpioChip()
+{
+    close();
+}
+
+bool GpioChip::open(const QString &device, const int offsets[], int count,
+                    int debounceUs)
+{
+    close();
+
+    m_chipFd = ::open(QFile::encodeName(device).constData(), O_RDWR | O_CLOEXEC);
+    if (m_chipFd < 0) {
+        qWarning() << "[GpioChip] Cannot open" << device;
+        return false;
+    }
+
+    gpio_v2_line_request req;
+    std::memset(&req, 0, sizeof(req));
+
+    for (int i = 0; i < count && m_numLines < kMaxLines; ++i) {
+        if (offsets[i] < 0)
+            continue;
+        m_offsets[m_numLines] = quint32(offsets[i]);
+        m_lineOf[m_numLines]  = i;
+        req.offsets[m_numLines] = quint32(offsets[i]);
+        ++m_numLines;
+    }
+
+    std::strncpy(req.consumer, "MazeProject", sizeof(req.consumer) - 1);
+    req.num_lines = quint32(m_numLines);
+    req.event_buffer_size = 64;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT |
+                       GPIO_V2_LINE_FLAG_EDGE_RISING |
+                       GPIO_V2_LINE_FLAG_EDGE_FALLING;
+
+    // Contact bounce is filtered by the kernel instead of the game loop
+    if (debounceUs > 0) {
+        req.config.num_attrs = 1;
+        req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+        req.config.attrs[0].attr.debounce_period_us = quint32(debounceUs);
+        req.config.attrs[0].mask = (m_numLines >= 64) ? ~0ULL
+                                                      : ((1ULL << m_numLines) - 1);
+    }
+
+    if (s_ioctl(m_chipFd, GPIO_V2_GET_LINE_IOCTL, &req) < 0 || req.fd < 0) {
+        qWarning() << "[GpioChip] Line request failed on" << device;
+        close();
+        return false;
+    }
+
+    m_requestFd = req.fd;
+    return true;
+}
+
+void GpioChip::close()
+{
+    if (m_requestFd >= 0) ::close(m_requestFd);
+    if (m_chipFd >= 0)    ::close(m_chipFd);
+    m_requestFd = -1;
+    m_chipFd    = -1;
+    m_numLines  = 0;
+}
+
+int GpioChip::lineForOffset(quint32 offset) const
+{
+    for (int k = 0; k < m_numLines; ++k) {
+        if (m_offsets[k] == offset)
+            return m_lineOf[k];
+    }
+    return -1;
+}
+
+bool GpioChip::readValues(bool values[], int count) const
+{
+    for (int i = 0; i < count; ++i)
+        values[i] = false;
+
+    if (m_requestFd < 0)
+        return false;
+
+    gpio_v2_line_values lv;
+    std::memset(&lv, 0, sizeof(lv));
+    lv.mask = (m_numLines >= 64) ? ~0ULL : ((1ULL << m_numLines) - 1);
+
+    if (s_ioctl(m_requestFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &lv) < 0)
+        return false;
+
+    for (int k = 0; k < m_numLines; ++k) {
+        if (m_lineOf[k] < count)
+            values[m_lineOf[k]] = (lv.bits >> k) & 1;
+    }
+    return true;
+}
+
+int GpioChip::readEvents(gpio_v2_line_event events[], int max) const
+{
+    if (m_requestFd < 0 || max <= 0)
+        return 0;
+
+    const ssize_t len = s_read(m_requestFd, events, size_t(max) * sizeof(gpio_v2_line_event));
+    if (len <= 0)
+        return 0;
+    return int(len / ssize_t(sizeof(gpio_v2_line_event)));
+}
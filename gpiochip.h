@@ -0,0 +1,57 @@
+#ifndef GPIOCHIP_H
+#define GPIOCHIP_H
+
+#include <QString>
+
+#include <sys/types.h>
+
+struct gpio_v2_line_event;
+
+// Input lines of one /dev/gpiochipN, requested through the GPIO character
+// device (uAPI v2). All lines are read with a single ioctl, debounced by
+// the kernel, and edge events come with kernel timestamps from the
+// request descriptor (read by GpioEdgeThread).
+class GpioChip
+{
+public:
+    static constexpr int kMaxLines = 8;
+
+    // Every ioctl goes through this hook so tests can fake a chip without
+    // the gpio-sim module; defaults to ::ioctl
+    using IoctlFn = int (*)(int fd, unsigned long request, void *arg);
+    static void setIoctl(IoctlFn fn);
+
+    // Likewise for reading edge events from the request; defaults to ::read
+    using ReadFn = ssize_t (*)(int fd, void *buf, size_t count);
+    static void setRead(ReadFn fn);
+
+    GpioChip() = default;
+    ~GpioChip();
+
+    // Request `count` lines (chip offsets) as inputs with both edges;
+    // offsets < 0 are skipped
+    bool open(const QString &device, const int offsets[], int count,
+              int debounceUs = 5000);
+    void close();
+
+    bool isOpen() const { return m_requestFd >= 0; }
+    int requestFd() const { return m_requestFd; }
+
+    // Line index (as passed to open) for an event's chip offset, or -1
+    int lineForOffset(quint32 offset) const;
+
+    // One GPIO_V2_LINE_GET_VALUES call for all requested lines
+    bool readValues(bool values[], int count) const;
+
+    // Pending edge events, at most `max`; returns how many were read
+    int readEvents(gpio_v2_line_event events[], int max) const;
+
+private:
+    int     m_chipFd = -1;
+    int     m_requestFd = -1;
+    int     m_numLines = 0;
+    quint32 m_offsets[kMaxLines] = {};
+    int     m_lineOf[kMaxLines] = {};   // request slot -> caller's line index
+};
+
+#endif // GPIOCHIP_H
@@ -1,179 +1,240 @@
 #include "gpiocontroller.h"
-#include "playeritem.h"
+#include "inputclock.h"
+#include "inputstate.h"
 
 #include <QFile>
-#include <QKeyEvent>
 #include <QDebug>
 
-GpioController::GpioController(int step, QObject *parent)
-    : QObject(parent),
-    m_player(nullptr),
-    m_moveLeft(false),
-    m_moveRight(false),
-    m_moveUp(false),
-    m_moveDown(false),
-    m_step(step),
-    m_gpioLeft(-1),
-    m_gpioRight(-1),
-    m_gpioUp(-1),
-    m_gpioDown(-1),
-    m_gpioAttack(-1),
-    m_attackPrev(false)
-{
-    // poll GPIO at 50 Hz
-    m_pollTimer.setInterval(20);
-    connect(&m_pollTimer, &QTimer::timeout,
-            this, &GpioController::pollInputs);
-    m_pollTimer.start();
-}
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
 
-void GpioController::setPlayer(PlayerItem *player)
+const quint8 kButton[] = {
+    InputState::Left, InputState::Right, InputState::Up,
+    InputState::Down, InputState::Attack
+};
+
+} // namespace
+
+GpioController::GpioController()
+    : m_sysfsRoot("/sys/class/gpio")
 {
-    m_player = player;
-    reset();
+    for (int i = 0; i < PinCount; ++i) {
+        m_level[i]  = false;
+        m_gpio[i]   = -1;
+        m_fd[i]     = -1;
+        m_isPipe[i] = false;
+    }
 }
 
-void GpioController::setStep(int step)
+GpioController::~GpioController()
 {
-    m_step = step;
+    closePins();
 }
 
-void GpioController::reset()
+void GpioController::attach(InputQueue *queue, quint8 source)
 {
-    m_moveLeft  = false;
-    m_moveRight = false;
-    m_moveUp    = false;
-    m_moveDown  = false;
-
-    if (m_player)
-        m_player->setAction(PlayerItem::Idle);
+    InputBackend::attach(queue, source);
+    openPins();
 }
 
-void GpioController::setGpios(int left, int right, int up, int down, int attack)
+void GpioController::setSysfsRoot(const QString &root)
 {
-    m_gpioLeft    = left;
-    m_gpioRight   = right;
-    m_gpioUp      = up;
-    m_gpioDown    = down;
-    m_gpioAttack  = attack;
+    m_sysfsRoot = root;
+    if (m_queue)
+        openPins();
 }
 
-// We keep these for interface compatibility with PlayerController,
-// but we don't actually use keyboard input here.
-bool GpioController::handleKeyPress(QKeyEvent *event)
+void GpioController::setChipDevice(const QString &device)
 {
-    Q_UNUSED(event);
-    return false;
+    m_chipDevice = device;
+    if (m_queue)
+        openPins();
 }
 
-bool GpioController::handleKeyRelease(QKeyEvent *event)
+void GpioController::setGpios(int left, int right, int up, int down, int attack)
 {
-    Q_UNUSED(event);
-    return false;
+    const int pins[PinCount] = { left, right, up, down, attack };
+    for (int i = 0; i < PinCount; ++i)
+        m_gpio[i] = pins[i];
+
+    if (m_queue)
+        openPins();
 }
 
-bool GpioController::readGpio(int gpio) const
+void GpioController::openPins()
 {
-    if (gpio < 0)
-        return false;
+    closePins();
 
-    QString path = QStringLiteral("/sys/class/gpio/gpio%1/value").arg(gpio);
-    QFile f(path);
+    bool anyPin = false;
+    for (int i = 0; i < PinCount; ++i)
+        anyPin = anyPin || m_gpio[i] >= 0;
+    if (!anyPin)
+        return;
 
-    if (!f.open(QIODevice::ReadOnly)) {
-        // qDebug() << "Failed to read" << path;
-        return false;
+    if (!m_chipDevice.isEmpty()) {
+        if (!m_chip.open(m_chipDevice, m_gpio, PinCount))
+            return;
+
+        // Events only report changes, so start from the current levels.
+        // A line already active now is not a press: no event for it
+        bool v[PinCount];
+        m_chip.readValues(v, PinCount);
+        for (int i = 0; i < PinCount; ++i)
+            m_level[i] = v[i];
+
+        m_edgeThread.setLineRequest(&m_chip, v, PinCount);
+        m_edgeThread.setOutput(m_queue, m_source, kButton);
+        m_edgeThread.start();
+        return;
     }
 
-    char c = 0;
-    if (f.read(&c, 1) != 1)
-        return false;
+    for (int i = 0; i < PinCount; ++i) {
+        if (m_gpio[i] < 0)
+            continue;
 
-    return (c == '1');  // active-high
+        QString path = QStringLiteral("%1/gpio%2/value").arg(m_sysfsRoot).arg(m_gpio[i]);
+        QByteArray native = QFile::encodeName(path);
+
+        // A named pipe stands in for a pin when testing; opening it
+        // read-write keeps it from reporting hang-up between writers
+        struct stat st;
+        const bool isPipe = (::stat(native.constData(), &st) == 0 && S_ISFIFO(st.st_mode));
+        m_isPipe[i] = isPipe;
+
+        m_fd[i] = ::open(native.constData(),
+                         (isPipe ? (O_RDWR | O_NONBLOCK) : O_RDONLY) | O_CLOEXEC);
+        if (m_fd[i] < 0)
+            qWarning() << "[GpioController] Cannot open" << path;
+    }
+
+    startEdgeThread();
 }
 
-void GpioController::pollInputs()
+bool GpioController::configureEdge(int gpio) const
 {
-    // Update movement booleans from GPIO pins
-    bool left   = readGpio(m_gpioLeft);
-    bool right  = readGpio(m_gpioRight);
-    bool up     = readGpio(m_gpioUp);
-    bool down   = readGpio(m_gpioDown);
-    bool attack = readGpio(m_gpioAttack);
-
-    m_moveLeft  = left;
-    m_moveRight = right;
-    m_moveUp    = up;
-    m_moveDown  = down;
-
-    if (!m_player)
-        return;
+    QString base = QStringLiteral("%1/gpio%2/").arg(m_sysfsRoot).arg(gpio);
+
+    struct stat st;
+    if (::stat(QFile::encodeName(base + "value").constData(), &st) == 0 &&
+        S_ISFIFO(st.st_mode))
+        return true;
+
+    // Interrupt on both edges so poll() wakes on press and release. Never
+    // create the file: a directory of plain value files has no edge
+    // support and must fall back to polling
+    int fd = ::open(QFile::encodeName(base + "edge").constData(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    bool ok = (::write(fd, "both", 4) == 4);
+    ::close(fd);
+    return ok;
+}
 
-    // ======== ATTACK BUTTON: on rising edge ========
-    if (attack && !m_attackPrev) {
-        // Only allow attack if not dying
-        if (m_player->action() != PlayerItem::Dying) {
-            m_player->setAction(PlayerItem::Attack);
-            emit attackTriggered();  // GameView will handle resolvePlayerAttack()
+void GpioController::startEdgeThread()
+{
+    bool usable = false;
+    for (int i = 0; i < PinCount; ++i) {
+        if (m_fd[i] < 0)
+            continue;
+        if (!configureEdge(m_gpio[i])) {
+            qDebug() << "[GpioController] No edge support on gpio" << m_gpio[i]
+                     << "- polling instead";
+            return;
         }
+        usable = true;
     }
-    m_attackPrev = attack;
-    // ===============================================
-
-    // If dying: freeze movement & DO NOT change animation anymore
-    if (m_player->action() == PlayerItem::Dying) {
-        m_moveLeft  = false;
-        m_moveRight = false;
-        m_moveUp    = false;
-        m_moveDown  = false;
+    if (!usable)
         return;
-    }
 
-    // Set direction & animation based on active movement
-    if (isMoving()) {
-        // Choose a primary direction; prioritize horizontal, then vertical
-        if (m_moveLeft) {
-            m_player->setDirection(PlayerItem::Left);
-        } else if (m_moveRight) {
-            m_player->setDirection(PlayerItem::Right);
-        } else if (m_moveUp) {
-            m_player->setDirection(PlayerItem::Back);
-        } else if (m_moveDown) {
-            m_player->setDirection(PlayerItem::Front);
-        }
+    m_edgeThread.setLines(m_fd, PinCount);
+    m_edgeThread.setOutput(m_queue, m_source, kButton);
+    m_edgeThread.start();
+}
 
-        // IMPORTANT: do NOT override Attack animation
-        if (m_player->action() != PlayerItem::Attack) {
-            m_player->setAction(PlayerItem::Run);
-        }
-    } else {
-        // No movement: only go Idle if not attacking
-        if (m_player->action() != PlayerItem::Attack &&
-            m_player->action() != PlayerItem::Dying) {
-            m_player->setAction(PlayerItem::Idle);
-        }
+void GpioController::closePins()
+{
+    // The thread polls these descriptors; it must go first
+    m_edgeThread.stop();
+    m_chip.close();
+
+    quint8 all = 0;
+    for (int i = 0; i < PinCount; ++i) {
+        if (m_fd[i] >= 0)
+            ::close(m_fd[i]);
+        m_fd[i]     = -1;
+        m_isPipe[i] = false;
+        m_level[i]  = false;
+        all |= kButton[i];
     }
+
+    // Whatever was held on the old pins is released
+    push(InputEvent::Release, all, 0);
 }
 
-QPointF GpioController::movementDelta() const
+void GpioController::readPins(bool values[PinCount]) const
 {
-    QPointF delta(0, 0);
+    if (m_chip.isOpen()) {
+        m_chip.readValues(values, PinCount);
+        return;
+    }
 
-    if (!m_player)
-        return delta;
+    // sysfs has no multi-pin read, so the batch is one read per pin on
+    // descriptors that stay open: no path building, open() or close()
+    for (int i = 0; i < PinCount; ++i) {
+        values[i] = m_level[i];
+        if (m_fd[i] < 0)
+            continue;
+
+        if (m_isPipe[i]) {
+            // Stand-in pipes cannot seek: take the last level written since
+            // the previous read, if any (the fd is non-blocking)
+            char buf[64];
+            ssize_t len;
+            while ((len = ::read(m_fd[i], buf, sizeof(buf))) > 0) {
+                for (ssize_t j = 0; j < len; ++j) {
+                    if (buf[j] == '0' || buf[j] == '1')
+                        values[i] = (buf[j] == '1');
+                }
+            }
+            continue;
+        }
 
-    if (m_player->action() == PlayerItem::Dying)
-        return delta;
+        // Value files report the level from offset 0 on every read
+        char c = 0;
+        values[i] = (::lseek(m_fd[i], 0, SEEK_SET) == 0 &&
+                     ::read(m_fd[i], &c, 1) == 1 &&
+                     c == '1');   // active-high
+    }
+}
 
-    if (m_moveLeft)  delta.rx() -= m_step;
-    if (m_moveRight) delta.rx() += m_step;
-    if (m_moveUp)    delta.ry() -= m_step;
-    if (m_moveDown)  delta.ry() += m_step;
+void GpioController::applyLevel(int pin, bool value, qint64 timestampNs)
+{
+    if (m_level[pin] == value)
+        return;
 
-    return delta;
+    m_level[pin] = value;
+    push(value ? InputEvent::Press : InputEvent::Release, kButton[pin], timestampNs);
 }
 
-bool GpioController::isMoving() const
+void GpioController::pump()
 {
-    return m_moveLeft || m_moveRight || m_moveUp || m_moveDown;
+    if (m_edgeThread.isRunning())
+        return;   // edges arrive on their own
+
+    bool anyOpen = false;
+    for (int i = 0; i < PinCount; ++i)
+        anyOpen = anyOpen || m_fd[i] >= 0;
+    if (!anyOpen && !m_chip.isOpen())
+        return;
+
+    // No edge interrupts: sample all pins and report the changes
+    bool v[PinCount];
+    readPins(v);
+    const qint64 now = inputClockNs();
+
+    for (int i = 0; i < PinCount; ++i)
+        applyLevel(i, v[i], now);
 }
@@ -1,64 +1,67 @@
 #ifndef GPIOCONTROLLER_H
 #define GPIOCONTROLLER_H
 
-#include <QObject>
-#include <QTimer>
-#include <QPointF>
+#include <QString>
 
-class PlayerItem;   // forward declaration
-class QKeyEvent;
+#include "gpiochip.h"
+#include "gpioedgethread.h"
+#include "inputbackend.h"
 
-class GpioController : public QObject
+// GPIO input backend. Pins are read through sysfs or the GPIO character
+// device; edges come from GpioEdgeThread where the pins support them,
+// otherwise every pin is sampled once per tick.
+class GpioController : public InputBackend
 {
-    Q_OBJECT
-
 public:
-    explicit GpioController(int step = 4, QObject *parent = nullptr);
+    GpioController();
+    ~GpioController() override;
 
-    // Same interface as PlayerController
-    void setPlayer(PlayerItem *player);
-    void setStep(int step);
-    void reset();
+    const char *name() const override { return "gpio"; }
 
-    // Kept for interface compatibility; always return false (no keyboard)
-    bool handleKeyPress(QKeyEvent *event);
-    bool handleKeyRelease(QKeyEvent *event);
+    // Opens the pins; edges go straight to the queue from the edge thread
+    void attach(InputQueue *queue, quint8 source) override;
 
-    QPointF movementDelta() const;
-    bool isMoving() const;
+    // Polling fallback when edges are unavailable
+    void pump() override;
 
-    // Extra: configure which GPIOs map to directions
-    void setGpios(int left, int right, int up, int down, int attack = -1);
+    // Directory holding gpioN/value files; a directory of plain files
+    // can stand in for /sys/class/gpio when testing without hardware
+    void setSysfsRoot(const QString &root);
 
-signals:
-    void attackTriggered();
+    // Use the GPIO character device (e.g. /dev/gpiochip0) instead of sysfs;
+    // pin numbers then are line offsets on that chip. Empty selects sysfs.
+    void setChipDevice(const QString &device);
 
-private slots:
-    void pollInputs();
+    // Extra: configure which GPIOs map to directions.
+    // Each pin's value file (or the chip's line request) is opened once;
+    // reads then reuse the descriptors.
+    void setGpios(int left, int right, int up, int down, int attack = -1);
 
-private:
-    bool readGpio(int gpio) const;
+    // True when input comes from the edge-triggered thread
+    bool isEdgeTriggered() const { return m_edgeThread.isRunning(); }
 
-    PlayerItem *m_player;
+private:
+    enum Pin { PinLeft, PinRight, PinUp, PinDown, PinAttack, PinCount };
 
-    // same logical movement flags as PlayerController
-    bool m_moveLeft;
-    bool m_moveRight;
-    bool m_moveUp;
-    bool m_moveDown;
+    void openPins();
+    void closePins();
+    bool configureEdge(int gpio) const;
+    void startEdgeThread();
+    void applyLevel(int pin, bool value, qint64 timestampNs);
+    void readPins(bool values[PinCount]) const;   // one read per pin
 
-    int m_step;
+    bool m_level[PinCount];   // last level pushed per pin (polling)
 
-    // GPIO pin numbers (sysfs indices)
-    int m_gpioLeft;
-    int m_gpioRight;
-    int m_gpioUp;
-    int m_gpioDown;
-    int m_gpioAttack;
+    QString  m_sysfsRoot;
+    QString  m_chipDevice;
+    GpioChip m_chip;
 
-    bool m_attackPrev;
+    // GPIO pin numbers (sysfs indices) and their open value files
+    int  m_gpio[PinCount];
+    int  m_fd[PinCount];
+    bool m_isPipe[PinCount];   // named-pipe stand-in rather than a value file
 
-    QTimer m_pollTimer;
+    GpioEdgeThread m_edgeThread;
 };
 
 #endif // GPIOCONTROLLER_H
@@ -0,0 +1,210 @@
+#include "gpioedgethread.h"
+#include "gpiochip.h"
+#include "inputclock.h"
+
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+GpioEdgeThread::GpioEdgeThread(QObject *parent)
+    : QThread(parent),
+    m_count(0),
+    m_chip(nullptr),
+    m_queue(nullptr),
+    m_source(0),
+    m_dropped(0)
+{
+    for (int i = 0; i < kMaxLines; ++i) {
+        m_fds[i]     = -1;
+        m_isPipe[i]  = false;
+        m_level[i]   = false;
+        m_buttons[i] = 0;
+    }
+
+    if (::pipe2(m_wakePipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        qWarning() << "[GpioEdgeThread] Cannot create wake pipe";
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+    }
+}
+
+GpioEdgeThread::~GpioEdgeThread()
+{
+    stop();
+
+    if (m_wakePipe[0] >= 0) ::close(m_wakePipe[0]);
+    if (m_wakePipe[1] >= 0) ::close(m_wakePipe[1]);
+}
+
+void GpioEdgeThread::setLines(const int fds[], int count)
+{
+    Q_ASSERT(!isRunning());
+
+    m_chip  = nullptr;
+    m_count = qMin(count, int(kMaxLines));
+    for (int i = 0; i < m_count; ++i) {
+        m_fds[i]   = fds[i];
+        m_level[i] = false;
+
+        struct stat st;
+        m_isPipe[i] = (fds[i] >= 0 && ::fstat(fds[i], &st) == 0 && S_ISFIFO(st.st_mode));
+    }
+}
+
+void GpioEdgeThread::setLineRequest(const GpioChip *chip, const bool initial[], int count)
+{
+    Q_ASSERT(!isRunning());
+
+    m_chip  = chip;
+    m_count = qMin(count, int(kMaxLines));
+    for (int i = 0; i < m_count; ++i) {
+        m_fds[i]    = -1;
+        m_isPipe[i] = false;
+        m_level[i]  = initial[i];
+    }
+}
+
+void GpioEdgeThread::setOutput(InputQueue *queue, quint8 source, const quint8 buttons[])
+{
+    Q_ASSERT(!isRunning());
+
+    m_queue  = queue;
+    m_source = source;
+    for (int i = 0; i < m_count; ++i)
+        m_buttons[i] = buttons[i];
+}
+
+void GpioEdgeThread::stop()
+{
+    if (!isRunning())
+        return;
+
+    const char c = 'q';
+    if (::write(m_wakePipe[1], &c, 1) != 1)
+        qWarning() << "[GpioEdgeThread] Cannot wake input thread";
+    wait();
+
+    // Leave the pipe empty for the next start()
+    char drain[16];
+    while (::read(m_wakePipe[0], drain, sizeof(drain)) > 0) {}
+}
+
+void GpioEdgeThread::publish(int line, bool value, qint64 timestampNs)
+{
+    if (m_level[line] == value)
+        return;
+    m_level[line] = value;
+
+    InputEvent e;
+    e.kind        = value ? InputEvent::Press : InputEvent::Release;
+    e.source      = m_source;
+    e.buttons     = m_buttons[line];
+    e.timestampNs = timestampNs;
+    if (!m_queue || !m_queue->push(e))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GpioEdgeThread::readLineEvents()
+{
+    gpio_v2_line_event events[16];
+    const int n = m_chip->readEvents(events, 16);
+    for (int i = 0; i < n; ++i) {
+        const int line = m_chip->lineForOffset(events[i].offset);
+        if (line < 0 || line >= m_count)
+            continue;
+
+        // CLOCK_MONOTONIC unless the request asked for another clock
+        publish(line, events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE,
+                qint64(events[i].timestamp_ns));
+    }
+}
+
+void GpioEdgeThread::run()
+{
+    pollfd pfds[kMaxLines + 1];
+    int    lineOf[kMaxLines + 1];
+    int    n = 0;
+
+    pfds[n].fd      = m_wakePipe[0];
+    pfds[n].events  = POLLIN;
+    lineOf[n++]     = -1;
+
+    if (m_chip) {
+        pfds[n].fd     = m_chip->requestFd();
+        pfds[n].events = POLLIN;
+        lineOf[n++]    = -1;
+    }
+
+    for (int i = 0; i < m_count && !m_chip; ++i) {
+        if (m_fds[i] < 0)
+            continue;
+
+        pfds[n].fd     = m_fds[i];
+        pfds[n].events = m_isPipe[i] ? POLLIN : (POLLPRI | POLLERR);
+        lineOf[n++]    = i;
+
+        // sysfs reports the current level; reading it also arms the edge.
+        // The initial level is not an input: stored, not published
+        char c = 0;
+        if (!m_isPipe[i] && ::pread(m_fds[i], &c, 1, 0) == 1)
+            m_level[i] = (c == '1');
+    }
+
+    for (;;) {
+        if (::poll(pfds, nfds_t(n), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            // Anything else would fail again at once; let pump() poll instead
+            qWarning() << "[GpioEdgeThread] poll failed:" << std::strerror(errno);
+            return;
+        }
+
+        const qint64 now = inputClockNs();
+
+        if (pfds[0].revents)
+            return;
+
+        if (m_chip) {
+            // A broken request keeps reporting the error: give up on it
+            // and let pump() sample the lines instead of spinning here
+            if (pfds[1].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                qWarning() << "[GpioEdgeThread] Line request failed, leaving";
+                return;
+            }
+            if (pfds[1].revents & POLLIN)
+                readLineEvents();
+            continue;
+        }
+
+        for (int k = 1; k < n; ++k) {
+            if (!pfds[k].revents)
+                continue;
+
+            // sysfs signals edges with POLLERR; only a closed fd is fatal
+            if (pfds[k].revents & POLLNVAL) {
+                qWarning() << "[GpioEdgeThread] Descriptor closed, leaving";
+                return;
+            }
+
+            const int line = lineOf[k];
+            if (m_isPipe[line]) {
+                // Stand-in: each '0'/'1' byte is one level, in order
+                char buf[64];
+                ssize_t len = ::read(m_fds[line], buf, sizeof(buf));
+                for (ssize_t j = 0; j < len; ++j) {
+                    if (buf[j] == '0' || buf[j] == '1')
+                        publish(line, buf[j] == '1', now);
+                }
+            } else {
+                char c = 0;
+                if (::pread(m_fds[line], &c, 1, 0) == 1)
+                    publish(line, c == '1', now);
+            }
+        }
+    }
+}
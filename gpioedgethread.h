@@ -0,0 +1,70 @@
+#ifndef GPIOEDGETHREAD_H
+#define GPIOEDGETHREAD_H
+
+#include <QThread>
+
+#include <atomic>
+
+#include "inputevent.h"
+
+class GpioChip;
+
+// Blocks in poll() on GPIO value descriptors and timestamps every
+// transition, so input arrives as soon as an edge fires instead of on the
+// next polling tick. Each change is pushed as a Press/Release InputEvent
+// into the game loop's lock-free input queue.
+//
+// sysfs value files (with their `edge` attribute set) signal POLLPRI and
+// are re-read at offset 0. Named pipes are accepted as a stand-in for
+// testing without hardware: every '0'/'1' written to them is one level.
+// A GpioChip line request delivers gpio_v2_line_event records instead,
+// stamped by the kernel when the edge fired.
+class GpioEdgeThread : public QThread
+{
+public:
+    static constexpr int kMaxLines = 8;
+
+    explicit GpioEdgeThread(QObject *parent = nullptr);
+    ~GpioEdgeThread() override;
+
+    // Descriptors stay owned by the caller; -1 entries are skipped.
+    // Only call while the thread is not running.
+    void setLines(const int fds[], int count);
+
+    // Read events from a character-device line request instead; `initial`
+    // holds the levels the consumer already knows about
+    void setLineRequest(const GpioChip *chip, const bool initial[], int count);
+
+    // Where events go: `buttons[i]` is the InputState button of line i
+    void setOutput(InputQueue *queue, quint8 source, const quint8 buttons[]);
+
+    // Wake poll() and join the thread
+    void stop();
+
+    // Events lost because the game loop did not drain the queue in time
+    quint32 droppedEvents() const { return m_dropped.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    void publish(int line, bool value, qint64 timestampNs);
+    void readLineEvents();
+
+    int  m_fds[kMaxLines];
+    bool m_isPipe[kMaxLines];
+    bool m_level[kMaxLines];
+    int  m_count;
+
+    const GpioChip *m_chip;
+
+    InputQueue *m_queue;
+    quint8      m_source;
+    quint8      m_buttons[kMaxLines];
+
+    int  m_wakePipe[2];   // written by stop() to interrupt poll()
+
+    std::atomic<quint32> m_dropped;
+};
+
+#endif // GPIOEDGETHREAD_H
@@ -0,0 +1,134 @@
+#include "headlessrunner.h"
+#include "launchoptions.h"
+#include "gamesimulation.h"
+#include "mazegenerator.h"
+#include "inputlog.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+namespace {
+
+// Stand-in for a player: holds a random direction for a while, attacks now
+// and then. Seeded, so every run feeds the same input sequence.
+class ScriptedBot
+{
+public:
+    explicit ScriptedBot(quint32 seed) : m_rng(seed) {}
+
+    InputState next()
+    {
+        InputState in;
+
+        if (m_ticksLeft-- <= 0) {
+            static const quint8 dirs[] = {
+                InputState::Left, InputState::Right,
+                InputState::Up,   InputState::Down,
+                InputState::Left | InputState::Up,
+                InputState::Right | InputState::Down
+            };
+            quint8 held = dirs[m_rng.bounded(6)];
+            in.pressed  = held & ~m_held;
+            m_held      = held;
+            m_ticksLeft = 15 + m_rng.bounded(60);
+        }
+
+        if (m_rng.bounded(100) < 3)
+            in.pressed |= InputState::Attack;
+
+        in.held = m_held;
+        return in;
+    }
+
+private:
+    QRandomGenerator m_rng;
+    quint8 m_held      = 0;
+    int    m_ticksLeft = 0;
+};
+
+// Same dimensions as GameView's levels
+const int kRowsCells = 10;
+const int kColsCells = 15;
+
+} // namespace
+
+HeadlessResult runHeadless(const LaunchOptions &options)
+{
+    HeadlessResult result;
+
+    InputReplay replay;
+    if (!options.replayPath.isEmpty() &&
+        !replay.open(options.replayPath, &result.error))
+        return result;
+
+    quint32 seed = QRandomGenerator::global()->generate();
+    if (replay.isOpen())
+        seed = replay.seed();
+    else if (options.hasSeed)
+        seed = options.seed;
+
+    InputRecorder recorder;
+    if (!options.recordPath.isEmpty() && !recorder.open(options.recordPath, seed)) {
+        result.error = "cannot write " + options.recordPath;
+        return result;
+    }
+
+    GameSimulation sim;
+    sim.setSeed(seed);
+    result.seed = seed;
+
+    ScriptedBot bot(options.botSeed);
+    QElapsedTimer timer;
+
+    bool inputLeft = true;
+    for (int level = 0; inputLeft && (replay.isOpen() || level < options.levels); ++level) {
+        // A replay decides level boundaries itself
+        if (replay.isOpen() && !replay.takeLevelStart())
+            break;
+
+        MazeGenerator gen(kRowsCells, kColsCells, sim.nextLevelSeed());
+        sim.loadLevel(gen.generate());
+        recorder.beginLevel();
+
+        timer.start();
+        int ticks = 0;
+        while (!sim.exitReached() && !sim.playerDead()) {
+            InputState in;
+            if (replay.isOpen()) {
+                if (!replay.next(&in)) {
+                    inputLeft = (replay.peek() == InputReplay::LevelStart);
+                    break;
+                }
+            } else {
+                if (ticks >= options.ticksPerLevel)
+                    break;
+                in = bot.next();
+            }
+
+            recorder.record(in);
+            sim.step(in);
+            sim.takeEvents();   // nobody renders them
+            ++ticks;
+        }
+        result.stepSeconds += timer.nsecsElapsed() / 1e9;
+
+        result.ticks += ticks;
+        ++result.levelsPlayed;
+        if (sim.exitReached())
+            ++result.levelsCleared;
+
+        if (sim.playerDead())
+            break;
+    }
+
+    result.stateHash = sim.stateHash();
+    recorder.finish(result.stateHash);
+
+    if (replay.isOpen() && replay.peek() == InputReplay::End && replay.hasFooter()) {
+        result.replayChecked = true;
+        result.replayMatched = (replay.recordedTicks() == result.ticks &&
+                                replay.recordedHash() == result.stateHash);
+    }
+
+    return result;
+}
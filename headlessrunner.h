@@ -0,0 +1,35 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QString>
+
+struct LaunchOptions;
+
+// Runs GameSimulation levels back to back with no window and no timers:
+// time only advances when a tick is stepped. Used for benchmarking the
+// gameplay logic and for running on machines without a display.
+// Input comes from a seeded scripted bot or from a recorded input log.
+struct HeadlessResult
+{
+    int     levelsPlayed  = 0;
+    int     levelsCleared = 0;   // exit reached
+    quint64 ticks         = 0;
+    double  stepSeconds   = 0.0; // wall time spent inside GameSimulation::step
+    quint32 seed          = 0;
+    quint64 stateHash     = 0;   // GameSimulation::stateHash() at the end
+
+    // Replays only: did the run end exactly like the recording?
+    bool    replayChecked = false;
+    bool    replayMatched = false;
+
+    QString error;
+
+    double ticksPerSecond() const
+    {
+        return stepSeconds > 0.0 ? ticks / stepSeconds : 0.0;
+    }
+};
+
+HeadlessResult runHeadless(const LaunchOptions &options);
+
+#endif // HEADLESSRUNNER_H
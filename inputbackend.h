@@ -0,0 +1,54 @@
+#ifndef INPUTBACKEND_H
+#define INPUTBACKEND_H
+
+#include "inputevent.h"
+
+class QKeyEvent;
+
+// A source of input events (keyboard, GPIO, replay). Backends push into the
+// InputHub's queue from whatever thread they run on; several can be
+// active at once.
+class InputBackend
+{
+public:
+    virtual ~InputBackend() = default;
+
+    virtual const char *name() const = 0;
+
+    // Called once by InputHub when the backend is added
+    virtual void attach(InputQueue *queue, quint8 source)
+    {
+        m_queue  = queue;
+        m_source = source;
+    }
+
+    // Game-loop thread, once per tick before the queue is drained; only
+    // needed by backends without their own thread or event source
+    virtual void pump() {}
+
+    // Keyboard events are offered to every backend; return true if used
+    virtual bool handleKeyPress(QKeyEvent *event)   { Q_UNUSED(event); return false; }
+    virtual bool handleKeyRelease(QKeyEvent *event) { Q_UNUSED(event); return false; }
+
+protected:
+    // False when the queue is full (the game loop stalled); the event is lost
+    bool push(InputEvent::Kind kind, quint8 buttons, qint64 timestampNs,
+              quint8 pressed = 0)
+    {
+        if (!m_queue)
+            return false;
+
+        InputEvent e;
+        e.kind        = kind;
+        e.source      = m_source;
+        e.buttons     = buttons;
+        e.pressed     = pressed;
+        e.timestampNs = timestampNs;
+        return m_queue->push(e);
+    }
+
+    InputQueue *m_queue  = nullptr;
+    quint8      m_source = 0;
+};
+
+#endif // INPUTBACKEND_H
@@ -0,0 +1,18 @@
+#ifndef INPUTCLOCK_H
+#define INPUTCLOCK_H
+
+#include <QtGlobal>
+
+#include <time.h>
+
+// CLOCK_MONOTONIC in nanoseconds: the clock GPIO character-device events
+// are stamped with, so every input source and the paint that shows its
+// effect can be compared directly.
+inline qint64 inputClockNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+#endif // INPUTCLOCK_H
@@ -0,0 +1,27 @@
+#ifndef INPUTEVENT_H
+#define INPUTEVENT_H
+
+#include <QtGlobal>
+
+#include "mpscqueue.h"
+
+// One change reported by an input backend
+struct InputEvent
+{
+    enum Kind : quint8 {
+        Press,      // `buttons` went down
+        Release,    // `buttons` went up
+        Snapshot    // complete tick input (`buttons` held, `pressed`), e.g. replay
+    };
+
+    Kind   kind        = Press;
+    quint8 source      = 0;   // backend slot in the InputHub
+    quint8 buttons     = 0;   // InputState::Button bits
+    quint8 pressed     = 0;   // Snapshot only
+    qint64 timestampNs = 0;   // inputClockNs() at capture; 0 = not measured
+};
+
+// Shared by all backends; drained by the game loop once per tick
+using InputQueue = MpscQueue<InputEvent, 1024>;
+
+#endif // INPUTEVENT_H
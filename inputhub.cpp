@@ -0,0 +1,103 @@
+#include "inputhub.h"
+#include "frameprofiler.h"
+
+InputHub::InputHub()
+{
+    for (int i = 0; i < kMaxBackends; ++i)
+        m_held[i] = 0;
+}
+
+// Backends (and their threads) stop before the queue goes away
+InputHub::~InputHub() = default;
+
+void InputHub::addBackend(InputBackend *backend)
+{
+    Q_ASSERT(int(m_backends.size()) < kMaxBackends);
+
+    backend->attach(&m_queue, quint8(m_backends.size()));
+    m_backends.emplace_back(backend);
+}
+
+QStringList InputHub::backendNames() const
+{
+    QStringList names;
+    for (const auto &b : m_backends)
+        names << QString::fromLatin1(b->name());
+    return names;
+}
+
+bool InputHub::handleKeyPress(QKeyEvent *event)
+{
+    bool handled = false;
+    for (const auto &b : m_backends)
+        handled = b->handleKeyPress(event) || handled;
+    return handled;
+}
+
+bool InputHub::handleKeyRelease(QKeyEvent *event)
+{
+    bool handled = false;
+    for (const auto &b : m_backends)
+        handled = b->handleKeyRelease(event) || handled;
+    return handled;
+}
+
+void InputHub::drain()
+{
+    InputEvent e;
+    while (m_queue.pop(e)) {
+        switch (e.kind) {
+        case InputEvent::Press:
+            m_held[e.source] |= e.buttons;
+            m_pressed        |= e.buttons;
+            break;
+        case InputEvent::Release:
+            m_held[e.source] &= quint8(~e.buttons);
+            break;
+        case InputEvent::Snapshot:
+            m_hasSnapshot      = true;
+            m_snapshot.held    = e.buttons;
+            m_snapshot.pressed = e.pressed;
+            break;
+        }
+
+        if (e.timestampNs && (!m_captureNs || e.timestampNs < m_captureNs))
+            m_captureNs = e.timestampNs;
+    }
+}
+
+InputState InputHub::takeInputState(qint64 *captureNs, bool *replayed)
+{
+    PROFILE_SCOPE("input");
+
+    for (const auto &b : m_backends)
+        b->pump();
+    drain();
+
+    InputState in;
+    for (int i = 0; i < kMaxBackends; ++i)
+        in.held |= m_held[i];
+    in.pressed = m_pressed;
+
+    *captureNs = m_captureNs;
+    *replayed  = m_hasSnapshot;
+    if (m_hasSnapshot) {
+        in = m_snapshot;
+        *captureNs = 0;   // not captured now
+    }
+
+    m_pressed     = 0;
+    m_captureNs   = 0;
+    m_hasSnapshot = false;
+    return in;
+}
+
+void InputHub::reset()
+{
+    // Apply queued releases so held buttons match the devices
+    drain();
+
+    m_pressed     = 0;
+    m_captureNs   = 0;
+    m_hasSnapshot = false;
+}
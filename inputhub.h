@@ -0,0 +1,52 @@
+#ifndef INPUTHUB_H
+#define INPUTHUB_H
+
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+#include "inputbackend.h"
+#include "inputstate.h"
+
+// Merges all active input backends through one lock-free event queue that
+// the game loop drains once per tick. Buttons are tracked per backend, so
+// a release on one device does not cancel a button held on another.
+class InputHub
+{
+public:
+    static constexpr int kMaxBackends = 8;
+
+    InputHub();
+    ~InputHub();
+
+    // Takes ownership; events from it are tagged with its slot
+    void addBackend(InputBackend *backend);
+    QStringList backendNames() const;
+
+    bool handleKeyPress(QKeyEvent *event);
+    bool handleKeyRelease(QKeyEvent *event);
+
+    // Input for the next simulation tick. captureNs gets the capture time
+    // of the oldest change in it (0 if none); replayed is set when a
+    // Snapshot backend supplied the whole tick, which overrides live input.
+    InputState takeInputState(qint64 *captureNs, bool *replayed);
+
+    // New level: forget presses not yet consumed; held buttons stay held
+    void reset();
+
+private:
+    void drain();
+
+    InputQueue m_queue;
+    std::vector<std::unique_ptr<InputBackend>> m_backends;
+
+    quint8     m_held[kMaxBackends];   // per backend
+    quint8     m_pressed   = 0;
+    qint64     m_captureNs = 0;
+
+    bool       m_hasSnapshot = false;
+    InputState m_snapshot;
+};
+
+#endif // INPUTHUB_H
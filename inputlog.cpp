@@ -0,0 +1,222 @@
+#include "inputlog.h"
+
+#include <QDebug>
+
+static const char  kMagic[4] = { 'M', 'Z', 'R', 'P' };
+static const quint8 kVersion = 1;
+
+// ===================== InputRecorder =====================
+
+InputRecorder::~InputRecorder()
+{
+    if (isOpen()) {
+        // No final hash available: close without a verifiable footer
+        flushRun();
+        m_file.write(m_buffer);
+        m_file.close();
+    }
+}
+
+bool InputRecorder::open(const QString &path, quint32 seed)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[InputRecorder] Cannot write" << path;
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.append(kMagic, 4);
+    m_buffer.append(char(kVersion));
+    for (int i = 0; i < 4; ++i)
+        m_buffer.append(char((seed >> (8 * i)) & 0xff));
+
+    m_runLength = 0;
+    m_ticks     = 0;
+    return true;
+}
+
+void InputRecorder::writeVarint(quint64 v)
+{
+    while (v >= 0x80) {
+        m_buffer.append(char((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    m_buffer.append(char(v));
+}
+
+void InputRecorder::flushRun()
+{
+    if (m_runLength == 0)
+        return;
+
+    m_buffer.append('I');
+    m_buffer.append(char(m_runInput.held));
+    m_buffer.append(char(m_runInput.pressed));
+    writeVarint(m_runLength);
+    m_runLength = 0;
+
+    // Hand full buffers to the OS; one write per few thousand runs
+    if (m_buffer.size() >= 4096) {
+        m_file.write(m_buffer);
+        m_buffer.clear();
+    }
+}
+
+void InputRecorder::beginLevel()
+{
+    if (!isOpen())
+        return;
+
+    flushRun();
+    m_buffer.append('L');
+}
+
+void InputRecorder::record(const InputState &input)
+{
+    if (!isOpen())
+        return;
+
+    if (m_runLength > 0 &&
+        (input.held != m_runInput.held || input.pressed != m_runInput.pressed))
+        flushRun();
+
+    m_runInput = input;
+    ++m_runLength;
+    ++m_ticks;
+}
+
+void InputRecorder::finish(quint64 stateHash)
+{
+    if (!isOpen())
+        return;
+
+    flushRun();
+    m_buffer.append('E');
+    writeVarint(m_ticks);
+    for (int i = 0; i < 8; ++i)
+        m_buffer.append(char((stateHash >> (8 * i)) & 0xff));
+
+    m_file.write(m_buffer);
+    m_buffer.clear();
+    m_file.close();
+}
+
+// ===================== InputReplay =====================
+
+bool InputReplay::open(const QString &path, QString *error)
+{
+    close();
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    m_data = f.readAll();
+
+    if (m_data.size() < 9 || !m_data.startsWith(QByteArray(kMagic, 4)) ||
+        quint8(m_data[4]) != kVersion) {
+        if (error) *error = "not an input log: " + path;
+        m_data.clear();
+        return false;
+    }
+
+    m_seed = 0;
+    for (int i = 0; i < 4; ++i)
+        m_seed |= quint32(quint8(m_data[5 + i])) << (8 * i);
+
+    m_pos  = 9;
+    m_open = true;
+    return true;
+}
+
+void InputReplay::close()
+{
+    m_data.clear();
+    m_pos       = 0;
+    m_open      = false;
+    m_runLeft   = 0;
+    m_hasFooter = false;
+}
+
+bool InputReplay::readVarint(quint64 *v)
+{
+    *v = 0;
+    for (int shift = 0; m_pos < m_data.size() && shift < 64; shift += 7) {
+        quint8 b = quint8(m_data[m_pos++]);
+        *v |= quint64(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+InputReplay::Record InputReplay::peek()
+{
+    if (!m_open)
+        return End;
+
+    // Load the next run once the current one is used up
+    while (m_runLeft == 0) {
+        if (m_pos >= m_data.size())
+            return End;
+
+        char tag = m_data[m_pos];
+        if (tag == 'L')
+            return LevelStart;
+
+        if (tag == 'E') {
+            ++m_pos;
+            if (!m_hasFooter && readVarint(&m_footerTicks) && m_pos + 8 <= m_data.size()) {
+                m_footerHash = 0;
+                for (int i = 0; i < 8; ++i)
+                    m_footerHash |= quint64(quint8(m_data[m_pos + i])) << (8 * i);
+                m_hasFooter = true;
+            }
+            m_pos = m_data.size();
+            return End;
+        }
+
+        if (tag != 'I' || m_pos + 3 > m_data.size()) {
+            qWarning() << "[InputReplay] Corrupt log at offset" << m_pos;
+            m_pos = m_data.size();
+            return End;
+        }
+
+        m_runInput.held    = quint8(m_data[m_pos + 1]);
+        m_runInput.pressed = quint8(m_data[m_pos + 2]);
+        m_pos += 3;
+        if (!readVarint(&m_runLeft)) {
+            m_pos = m_data.size();
+            return End;
+        }
+    }
+    return Tick;
+}
+
+bool InputReplay::takeLevelStart()
+{
+    if (peek() != LevelStart)
+        return false;
+    ++m_pos;
+    return true;
+}
+
+bool InputReplay::next(InputState *input)
+{
+    if (peek() != Tick)
+        return false;
+
+    *input = m_runInput;
+    --m_runLeft;
+    return true;
+}
+
+void ReplayInputBackend::pump()
+{
+    // Level markers and the footer are consumed by the game loop itself
+    InputState in;
+    if (m_replay->isOpen() && m_replay->next(&in))
+        push(InputEvent::Snapshot, in.held, 0, in.pressed);
+}
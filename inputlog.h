@@ -0,0 +1,98 @@
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "inputbackend.h"
+#include "inputstate.h"
+
+// Compact per-tick input log: the session seed followed by run-length
+// encoded InputStates and level-start markers, closed by a footer with the
+// tick count and GameSimulation::stateHash(). Replaying it through a
+// simulation with the same seed reproduces the session bit for bit.
+//
+// Layout (little endian):
+//   "MZRP" u8 version u32 seed
+//   'L'                               new level
+//   'I' u8 held u8 pressed varint n   same input for n ticks
+//   'E' varint ticks u64 hash         end of session
+class InputRecorder
+{
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    bool open(const QString &path, quint32 seed);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void beginLevel();
+    void record(const InputState &input);
+
+    // Write the footer and close; safe to call more than once
+    void finish(quint64 stateHash);
+
+private:
+    void flushRun();
+    void writeVarint(quint64 v);
+
+    QFile      m_file;
+    QByteArray m_buffer;
+    InputState m_runInput;
+    quint64    m_runLength = 0;
+    quint64    m_ticks     = 0;
+};
+
+class InputReplay
+{
+public:
+    enum Record { Tick, LevelStart, End };
+
+    bool open(const QString &path, QString *error = nullptr);
+    bool isOpen() const { return m_open; }
+
+    quint32 seed() const { return m_seed; }
+
+    Record peek();
+    bool   takeLevelStart();          // consume a level marker if it is next
+    bool   next(InputState *input);   // false unless a tick was next
+
+    // Footer data, valid once peek() returned End
+    bool    hasFooter() const     { return m_hasFooter; }
+    quint64 recordedTicks() const { return m_footerTicks; }
+    quint64 recordedHash() const  { return m_footerHash; }
+
+    void close();
+
+private:
+    bool readVarint(quint64 *v);
+
+    QByteArray m_data;
+    int        m_pos   = 0;
+    bool       m_open  = false;
+    quint32    m_seed  = 0;
+
+    InputState m_runInput;
+    quint64    m_runLeft = 0;
+
+    bool    m_hasFooter   = false;
+    quint64 m_footerTicks = 0;
+    quint64 m_footerHash  = 0;
+};
+
+// Input backend that plays an InputReplay: pushes each recorded tick as a
+// Snapshot, which replaces live input for that tick
+class ReplayInputBackend : public InputBackend
+{
+public:
+    explicit ReplayInputBackend(InputReplay *replay) : m_replay(replay) {}
+
+    const char *name() const override { return "replay"; }
+    void pump() override;
+
+private:
+    InputReplay *m_replay;
+};
+
+#endif // INPUTLOG_H
@@ -0,0 +1,28 @@
+#ifndef INPUTSTATE_H
+#define INPUTSTATE_H
+
+#include <QtGlobal>
+
+// Input for one simulation tick, independent of where it came from
+// (keyboard, GPIO, scripted bot). Fits in two bytes.
+struct InputState
+{
+    enum Button : quint8 {
+        Left   = 0x01,
+        Right  = 0x02,
+        Up     = 0x04,
+        Down   = 0x08,
+        Attack = 0x10,
+
+        DirectionMask = Left | Right | Up | Down
+    };
+
+    quint8 held    = 0;   // buttons currently down
+    quint8 pressed = 0;   // buttons that went down since the previous tick
+
+    bool isHeld(Button b) const     { return (held & b) != 0; }
+    bool wasPressed(Button b) const { return (pressed & b) != 0; }
+    bool isMoving() const           { return (held & DirectionMask) != 0; }
+};
+
+#endif // INPUTSTATE_H
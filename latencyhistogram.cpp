@@ -0,0 +1,65 @@
+#include "latencyhistogram.h"
+
+#include <QFile>
+#include <QTextStream>
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(kBuckets + 1, 0)
+{
+}
+
+void LatencyHistogram::record(qint64 latencyNs)
+{
+    if (latencyNs < 0)
+        latencyNs = 0;
+
+    int bucket = int(latencyNs / qint64(kBucketMs * 1e6));
+    m_buckets[qMin(bucket, int(kBuckets))] += 1;
+
+    ++m_count;
+    m_maxNs = qMax(m_maxNs, latencyNs);
+}
+
+void LatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_maxNs = 0;
+}
+
+double LatencyHistogram::percentileMs(double p) const
+{
+    if (m_count == 0)
+        return 0.0;
+
+    const quint64 target = quint64(qBound(0.0, p, 1.0) * double(m_count - 1)) + 1;
+    quint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i];
+        if (seen >= target)
+            return (i + 1) * kBucketMs;
+    }
+    return maxMs();   // in the overflow bucket
+}
+
+bool LatencyHistogram::writeCsv(const QString &path) const
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QTextStream out(&f);
+    out << "# samples " << m_count
+        << "  p50 " << percentileMs(0.50)
+        << "  p95 " << percentileMs(0.95)
+        << "  p99 " << percentileMs(0.99)
+        << "  max " << maxMs() << " ms\n";
+    out << "upper_ms,count\n";
+    for (int i = 0; i < kBuckets; ++i) {
+        if (m_buckets[i])
+            out << (i + 1) * kBucketMs << ',' << m_buckets[i] << '\n';
+    }
+    if (m_buckets[kBuckets])
+        out << "inf," << m_buckets[kBuckets] << '\n';
+    return true;
+}
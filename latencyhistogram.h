@@ -0,0 +1,33 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QString>
+#include <QVector>
+
+// Fixed-bucket latency histogram: 0.25 ms buckets up to 250 ms plus one
+// overflow bucket. Recording is O(1) and never allocates.
+class LatencyHistogram
+{
+public:
+    static constexpr int    kBuckets  = 1000;
+    static constexpr double kBucketMs = 0.25;
+
+    LatencyHistogram();
+
+    void record(qint64 latencyNs);
+    void reset();
+
+    quint64 count() const { return m_count; }
+    double percentileMs(double p) const;   // p in [0, 1]; upper bucket edge
+    double maxMs() const { return m_maxNs / 1e6; }
+
+    // "upper_ms,count" rows after a percentile summary
+    bool writeCsv(const QString &path) const;
+
+private:
+    QVector<quint32> m_buckets;   // kBuckets + overflow
+    quint64          m_count = 0;
+    qint64           m_maxNs = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,87 @@
+#include "launchoptions.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+
+static bool hasFlag(int argc, char *argv[], const char *flag)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], flag) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool wantsHeadless(int argc, char *argv[])
+{
+    return hasFlag(argc, argv, "--headless");
+}
+
+bool wantsPackAssets(int argc, char *argv[])
+{
+    return hasFlag(argc, argv, "--pack-assets");
+}
+
+LaunchOptions parseLaunchOptions(const QCoreApplication &app)
+{
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({ "headless", "Run the simulation without rendering." });
+    parser.addOption({ "seed", "Session seed (levels and monsters).", "seed" });
+    parser.addOption({ "record", "Record per-tick input to a log file.", "file" });
+    parser.addOption({ "replay", "Replay a recorded input log.", "file" });
+    parser.addOption({ "input", "Input backends, comma separated (keyboard, gpio).",
+                       "list", "keyboard,gpio" });
+    parser.addOption({ "gpio-root", "Directory holding gpioN/value files.", "dir",
+                       "/sys/class/gpio" });
+    parser.addOption({ "gpio-chip", "Read GPIO through this character device.", "device" });
+    parser.addOption({ "gpio-pins", "GPIO left,right,up,down,attack.", "list",
+                       "67,68,44,26,46" });
+    parser.addOption({ "assets", "Packed asset archive to load from.", "file" });
+    parser.addOption({ "pack-assets", "Pack the asset folders into an archive and exit.",
+                       "file" });
+    parser.addOption({ "bench-render", "Measure scene cost against monster count and exit." });
+    parser.addOption({ "renderer", "Renderer: scene or soft.", "name", "scene" });
+    parser.addOption({ "fb", "Soft renderer: write frames to this framebuffer device or file.",
+                       "path" });
+    parser.addOption({ "fb-format", "Pixel format of a --fb file: rgb565 or xrgb8888.",
+                       "format", "rgb565" });
+    parser.addOption({ "open-world", "Endless maze streamed in chunks." });
+    parser.addOption({ "world-budget", "Open world: memory for resident chunks.", "MB", "24" });
+    parser.addOption({ "fov", "Dark corridors: draw only what the player can see." });
+    parser.addOption({ "fov-radius", "Sight radius in cells.", "cells", "8" });
+    parser.addOption({ "levels", "Headless: number of levels to simulate.", "n", "10" });
+    parser.addOption({ "ticks", "Headless: tick limit per level.", "n", "7200" });
+    parser.addOption({ "bot-seed", "Headless: seed of the scripted input.", "seed", "1" });
+    parser.process(app);
+
+    LaunchOptions o;
+    o.headless      = parser.isSet("headless");
+    o.hasSeed       = parser.isSet("seed");
+    o.seed          = parser.value("seed").toUInt();
+    o.recordPath    = parser.value("record");
+    o.replayPath    = parser.value("replay");
+    o.inputs        = parser.value("input").split(',', Qt::SkipEmptyParts);
+    o.gpioRoot      = parser.value("gpio-root");
+    o.gpioChip      = parser.value("gpio-chip");
+    o.assetArchive  = parser.value("assets");
+    o.packAssets    = parser.value("pack-assets");
+    o.benchRender   = parser.isSet("bench-render");
+    o.framebuffer   = parser.value("fb");
+    o.framebufferFormat = parser.value("fb-format");
+    o.renderer      = o.framebuffer.isEmpty() ? parser.value("renderer") : QString("soft");
+    o.openWorld     = parser.isSet("open-world");
+    o.worldBudgetMb = parser.value("world-budget").toInt();
+    o.fov           = parser.isSet("fov");
+    o.fovRadius     = parser.value("fov-radius").toInt();
+
+    const QStringList pins = parser.value("gpio-pins").split(',');
+    for (int i = 0; i < 5; ++i)
+        o.gpioPins[i] = (i < pins.size()) ? pins[i].trimmed().toInt() : -1;
+
+    o.levels        = parser.value("levels").toInt();
+    o.ticksPerLevel = parser.value("ticks").toInt();
+    o.botSeed       = parser.value("bot-seed").toUInt();
+    return o;
+}
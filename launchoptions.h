@@ -0,0 +1,60 @@
+#ifndef LAUNCHOPTIONS_H
+#define LAUNCHOPTIONS_H
+
+#include <QString>
+#include <QStringList>
+
+class QCoreApplication;
+
+// Command-line settings shared by the windowed game and headless mode
+struct LaunchOptions
+{
+    bool    headless = false;
+
+    bool    hasSeed  = false;   // otherwise a random session seed is used
+    quint32 seed     = 0;
+
+    QString recordPath;         // write per-tick input here
+    QString replayPath;         // feed per-tick input from here
+
+    // Active input backends (keyboard, gpio); a replay is added when given
+    QStringList inputs = { "keyboard", "gpio" };
+
+    QString gpioRoot = "/sys/class/gpio";   // sysfs GPIO directory
+    QString gpioChip;                       // e.g. /dev/gpiochip0; empty = sysfs
+
+    // Left, right, up, down, attack: sysfs numbers, or line offsets on gpioChip
+    int     gpioPins[5] = { 67, 68, 44, 26, 46 };
+
+    QString assetArchive;       // packed assets; default <app dir>/assets.pak if present
+    QString packAssets;         // write an archive of the asset folders and exit
+
+    bool    benchRender = false; // print scene cost vs monster count and exit
+
+    // "scene" (QGraphicsView) or "soft" (SoftRenderer into one image)
+    QString renderer = "scene";
+    QString framebuffer;                    // soft frames go here, e.g. /dev/fb0 or a file
+    QString framebufferFormat = "rgb565";   // rgb565 or xrgb8888; devices use their own
+
+    // Endless maze streamed in chunks instead of levels with an exit
+    bool    openWorld     = false;
+    int     worldBudgetMb = 24;   // resident chunks, grid and tile pixels
+
+    // Line of sight: only what the player can see is drawn
+    bool    fov       = false;
+    int     fovRadius = 8;        // cells
+
+    // Headless only
+    int     levels        = 10;
+    int     ticksPerLevel = 60 * 60 * 2;
+    quint32 botSeed       = 1;
+};
+
+// Is --headless among the raw arguments? Decides the application type
+// before any QCoreApplication exists.
+bool wantsHeadless(int argc, char *argv[]);
+bool wantsPackAssets(int argc, char *argv[]);
+
+LaunchOptions parseLaunchOptions(const QCoreApplication &app);
+
+#endif // LAUNCHOPTIONS_H
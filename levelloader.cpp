@@ -0,0 +1,253 @@
+#include "levelloader.h"
+#include "assetcache.h"
+#include "frameprofiler.h"
+#include "textures.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace {
+
+using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+AssetRequest scaledRequest(const QString &path, int w, int h, Qt::AspectRatioMode mode)
+{
+    AssetRequest req;
+    req.path = path;
+    req.size = QSize(w, h);
+    req.mode = mode;
+    return req;
+}
+
+QVector<AssetRequest> tileRequests(const QString &basePath, const TextureFamily &family,
+                                   int cellSize)
+{
+    QVector<AssetRequest> reqs;
+    for (int i = 0; i < family.count; ++i)
+        reqs.append(textureRequest(textureFilePath(basePath, family, i), cellSize));
+    return reqs;
+}
+
+// Single images placed by the level: exit, doors, key and monster sprites
+struct PropRequests
+{
+    AssetRequest exit, door, openDoor, key, damageMonster, slowMonster;
+
+    QVector<AssetRequest> all() const
+    {
+        return { exit, door, openDoor, key, damageMonster, slowMonster };
+    }
+};
+
+PropRequests propRequests(const QString &assetRoot, int cs, int mazeScale)
+{
+    const QString tex = assetRoot + "/texture/";
+    const int big = mazeScale * cs;
+
+    PropRequests p;
+    p.exit     = scaledRequest(tex + "exit/stone_stairs_down.png",
+                               big, big, Qt::KeepAspectRatioByExpanding);
+    p.door     = scaledRequest(tex + "doors/closed/dngn_closed_door.png",
+                               big, big, Qt::KeepAspectRatioByExpanding);
+    p.openDoor = scaledRequest(tex + "doors/open/dngn_open_door.png",
+                               big, big, Qt::KeepAspectRatioByExpanding);
+    p.key      = scaledRequest(tex + "keys/key.png", int(cs * 0.8), int(cs * 1.2),
+                               Qt::KeepAspectRatio);
+    p.damageMonster.path = assetRoot + "/monsters/damage.png";
+    p.slowMonster.path   = assetRoot + "/monsters/slow.png";
+    return p;
+}
+
+// Every frame of every animation folder, per PlayerSprites::specs() entry
+QVector<QVector<AssetRequest>> playerRequests(const QString &spriteRoot, int cs)
+{
+    const auto &specs = PlayerSprites::specs();
+    QVector<QVector<AssetRequest>> reqs(specs.size());
+
+    const qreal scale = PlayerSprites::frameScale(spriteRoot, cs);
+    for (int i = 0; i < specs.size(); ++i) {
+        const QString folder = spriteRoot + "/" + specs[i].folder;
+        for (const QString &path : PlayerSprites::framePaths(folder))
+            reqs[i].append(PlayerSprites::frameRequest(path, scale));
+    }
+    return reqs;
+}
+
+// Drop tiles whose file was missing so baked indices stay dense
+void compact(QVector<QImage> &images)
+{
+    images.erase(std::remove_if(images.begin(), images.end(),
+                                [](const QImage &img) { return img.isNull(); }),
+                 images.end());
+}
+
+LevelAssets buildLevel(const LevelRequest &req, CancelFlag cancel)
+{
+    LevelAssets a;
+    QElapsedTimer t;
+    t.start();
+
+    auto endStage = [&](const char *name) {
+        a.stageMs.append(qMakePair(name, t.nsecsElapsed() / 1e6));
+        t.restart();
+    };
+
+    // ---- Stage 1: maze generation ----
+    {
+        PROFILE_SCOPE("loadGenerate");
+        MazeGenerator gen(req.rows, req.cols, req.seed);
+        a.maze = gen.generate();
+    }
+    endStage("generate");
+    if (*cancel)
+        return a;
+
+    // Texture choice and tile baking follow the level seed; visuals only
+    QRandomGenerator rng(req.seed ^ 0x5bd1e995u);
+
+    const QVector<TextureFamily> walls  = wallFamilies();
+    const QVector<TextureFamily> floors = floorFamilies();
+    const TextureFamily wall  = walls[rng.bounded(walls.size())];
+    const TextureFamily floor = floors[rng.bounded(floors.size())];
+    a.wallPrefix  = wall.prefix;
+    a.floorPrefix = floor.prefix;
+
+    // ---- Stage 2: decode and scale every image, in parallel ----
+    {
+        PROFILE_SCOPE("loadDecode");
+
+        const int cs = req.cellSize;
+        const QString tex = req.assetRoot + "/texture/";
+
+        const QVector<AssetRequest> wallReqs  = tileRequests(tex + "walls/", wall, cs);
+        const QVector<AssetRequest> floorReqs = tileRequests(tex + "floor/", floor, cs);
+        const PropRequests props = propRequests(req.assetRoot, cs, a.maze.scale);
+
+        const auto &specs = PlayerSprites::specs();
+        QVector<QVector<AssetRequest>> frameReqs(specs.size());
+        if (!req.spriteRoot.isEmpty())
+            frameReqs = playerRequests(req.spriteRoot, cs);
+
+        QVector<AssetRequest> all = wallReqs + floorReqs + props.all();
+        for (const QVector<AssetRequest> &frames : frameReqs)
+            all += frames;
+
+        AssetCache &cache = AssetCache::instance();
+        cache.load(all, cancel.get());
+
+        // Every request is cached now, so these are lookups
+        if (!*cancel) {
+            for (const AssetRequest &r : wallReqs)
+                a.wallTiles.append(cache.image(r));
+            for (const AssetRequest &r : floorReqs)
+                a.floorTiles.append(cache.image(r));
+
+            a.exitImage          = cache.image(props.exit);
+            a.doorImage          = cache.image(props.door);
+            a.openDoorImage      = cache.image(props.openDoor);
+            a.keyImage           = cache.image(props.key);
+            a.damageMonsterImage = cache.image(props.damageMonster);
+            a.slowMonsterImage   = cache.image(props.slowMonster);
+
+            for (int i = 0; i < specs.size(); ++i) {
+                PlayerSprites::Animation anim;
+                anim.fps = specs[i].fps;
+                for (const AssetRequest &r : frameReqs[i]) {
+                    const QImage img = cache.image(r);
+                    if (!img.isNull())
+                        anim.frames.append(img);
+                }
+                a.player.animations[i] = anim;
+            }
+            compact(a.wallTiles);
+            compact(a.floorTiles);
+        }
+    }
+    endStage("decode");
+    if (*cancel)
+        return a;
+
+    // ---- Stage 3: bake the tile variant of every cell ----
+    {
+        PROFILE_SCOPE("loadBake");
+
+        const auto &grid = a.maze.grid;
+        const int rows = int(grid.size());
+        const int cols = rows ? int(grid[0].size()) : 0;
+
+        a.tileVariant.resize(rows * cols);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const int n = (grid[r][c] == 1) ? a.wallTiles.size()
+                                                : a.floorTiles.size();
+                a.tileVariant[r * cols + c] = n ? qint8(rng.bounded(n)) : qint8(-1);
+            }
+        }
+    }
+    endStage("bake");
+
+    return a;
+}
+
+} // namespace
+
+QVector<AssetRequest> LevelLoader::warmUpRequests(const QString &assetRoot, int cellSize,
+                                                  const QStringList &spriteRoots)
+{
+    const QString tex = assetRoot + "/texture/";
+
+    QVector<AssetRequest> reqs;
+    for (const TextureFamily &family : wallFamilies())
+        reqs += tileRequests(tex + "walls/", family, cellSize);
+    for (const TextureFamily &family : floorFamilies())
+        reqs += tileRequests(tex + "floor/", family, cellSize);
+
+    reqs += propRequests(assetRoot, cellSize, MazeGenerator::MazeData().scale).all();
+
+    for (const QString &root : spriteRoots) {
+        for (const QVector<AssetRequest> &frames : playerRequests(root, cellSize))
+            reqs += frames;
+    }
+    return reqs;
+}
+
+LevelLoader::LevelLoader(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<LevelAssets>::finished,
+            this, &LevelLoader::onFinished);
+}
+
+LevelLoader::~LevelLoader()
+{
+    // The worker only touches its own copies; it may finish on its own
+    cancel();
+}
+
+void LevelLoader::start(const LevelRequest &request)
+{
+    cancel();
+
+    m_cancel = std::make_shared<std::atomic<bool>>(false);
+    m_watcher.setFuture(QtConcurrent::run(buildLevel, request, m_cancel));
+}
+
+void LevelLoader::cancel()
+{
+    if (m_cancel)
+        *m_cancel = true;
+    m_cancel.reset();
+}
+
+void LevelLoader::onFinished()
+{
+    // A cancelled load never reaches the scene
+    if (!m_cancel || *m_cancel)
+        return;
+
+    m_cancel.reset();
+    emit loaded(m_watcher.result());
+}
@@ -0,0 +1,90 @@
+#ifndef LEVELLOADER_H
+#define LEVELLOADER_H
+
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+#include "assetcache.h"
+#include "mazegenerator.h"
+#include "playeritem.h"
+
+// What to load for one level
+struct LevelRequest
+{
+    int     rows     = 10;
+    int     cols     = 15;
+    int     cellSize = 32;
+    quint32 seed     = 0;
+    QString assetRoot;    // directory holding texture/
+    QString spriteRoot;   // character sprites; empty if already loaded
+};
+
+// Everything a level needs before it goes into the scene. Plain data and
+// QImages only, so it is built entirely on worker threads.
+struct LevelAssets
+{
+    MazeGenerator::MazeData maze;
+
+    QString         wallPrefix;
+    QString         floorPrefix;
+    QVector<QImage> wallTiles;     // scaled to the cell size
+    QVector<QImage> floorTiles;
+    QImage          exitImage;     // scaled to their final size
+    QImage          doorImage;
+    QImage          openDoorImage;
+    QImage          keyImage;
+    QImage          damageMonsterImage;   // file size
+    QImage          slowMonsterImage;
+
+    // Baked tile choice per cell (row-major): index into wallTiles or
+    // floorTiles by cell type, -1 when there is no texture
+    QVector<qint8>  tileVariant;
+
+    PlayerSprites   player;        // empty unless requested
+
+    // Wall-clock time per stage, in order
+    QVector<QPair<const char*, double>> stageMs;
+};
+
+// Staged level loading on the global thread pool: maze generation, image
+// decoding and scaling (in parallel, through AssetCache) and tile baking.
+// The GUI thread only receives the finished LevelAssets for the scene hookup.
+class LevelLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LevelLoader(QObject *parent = nullptr);
+    ~LevelLoader() override;
+
+    // Cancels a load still in progress
+    void start(const LevelRequest &request);
+    void cancel();
+
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    // Everything a first level may need: every tile family, the props and
+    // the frames of each character, keyed exactly as buildLevel asks for
+    // them. For AssetCache::preload before a game starts.
+    static QVector<AssetRequest> warmUpRequests(const QString &assetRoot, int cellSize,
+                                                const QStringList &spriteRoots);
+
+signals:
+    void loaded(const LevelAssets &assets);
+
+private:
+    void onFinished();
+
+    QFutureWatcher<LevelAssets>        m_watcher;
+    std::shared_ptr<std::atomic<bool>> m_cancel;
+};
+
+#endif // LEVELLOADER_H
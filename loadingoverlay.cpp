@@ -1,4 +1,7 @@
 #include "loadingoverlay.h"
+#include "assetcache.h"
+
+#include <QIODevice>
 #include <QResizeEvent>
 
 LoadingOverlay::LoadingOverlay(QWidget *parent)
@@ -35,7 +38,12 @@ void LoadingOverlay::setGif(const QString &resourcePath)
         m_movie = nullptr;
     }
 
-    m_movie = new QMovie(resourcePath, QByteArray(), this);
+    // From the asset archive when packed; the movie owns the device
+    QIODevice *gif = AssetCache::instance().openFile(resourcePath);
+    m_movie = gif ? new QMovie(gif, QByteArray(), this)
+                  : new QMovie(resourcePath, QByteArray(), this);
+    if (gif)
+        gif->setParent(m_movie);
     m_movie->setCacheMode(QMovie::CacheAll);
 
     // Force infinite looping: when the movie finishes, restart it
@@ -1,11 +1,116 @@
 #include <QApplication>
+#include <QTextStream>
 #include "startmenu.h"
+#include "launchoptions.h"
+#include "headlessrunner.h"
+#include "assetcache.h"
+#include "renderbench.h"
+
+#include <QDebug>
+#include <QFile>
+
+// Asset folders below the executable's directory
+static const QStringList kAssetFolders = { "texture", "characters", "monsters" };
+
+static int runHeadlessMode(int argc, char *argv[])
+{
+    // Gameplay only needs QtCore: no display or platform plugin required
+    QCoreApplication app(argc, argv);
+    LaunchOptions options = parseLaunchOptions(app);
+
+    HeadlessResult r = runHeadless(options);
+
+    QTextStream out(stdout);
+    if (!r.error.isEmpty()) {
+        out << "error: " << r.error << "\n";
+        return 1;
+    }
+
+    out << "seed " << r.seed << "\n"
+        << "levels " << r.levelsPlayed << " (cleared " << r.levelsCleared << ")\n"
+        << "ticks " << r.ticks << " in " << r.stepSeconds << " s\n"
+        << "throughput " << qRound64(r.ticksPerSecond()) << " ticks/s\n"
+        << "state hash " << QString::number(r.stateHash, 16) << "\n";
+
+    if (r.replayChecked) {
+        out << "replay " << (r.replayMatched ? "matches recording" : "DIVERGED") << "\n";
+        return r.replayMatched ? 0 : 2;
+    }
+    return 0;
+}
+
+static int runPackAssets(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    LaunchOptions options = parseLaunchOptions(app);
+
+    int files = 0;
+    QString error;
+    QTextStream out(stdout);
+    if (!AssetArchive::pack(QCoreApplication::applicationDirPath(), kAssetFolders,
+                            options.packAssets, &files, &error)) {
+        out << "error: " << error << "\n";
+        return 1;
+    }
+    out << "packed " << files << " files into " << options.packAssets << "\n";
+    return 0;
+}
+
+static int runRenderBenchMode()
+{
+    QTextStream out(stdout);
+    out << "layout              monsters   move ms  query ms  paint ms  (per frame)\n";
+    for (const RenderBenchRow &r : runRenderBench()) {
+        out << QString("%1 %2 %3 %4 %5\n")
+                   .arg(QString::fromLatin1(r.layout), -19)
+                   .arg(r.monsters, 8)
+                   .arg(r.moveMs, 9, 'f', 3)
+                   .arg(r.queryMs, 9, 'f', 3)
+                   .arg(r.paintMs, 9, 'f', 3);
+    }
+    return 0;
+}
+
+// Serve images from the packed archive when there is one
+static void mountAssets(const LaunchOptions &options)
+{
+    const QString root = QCoreApplication::applicationDirPath();
+    QString path = options.assetArchive;
+    if (path.isEmpty()) {
+        path = root + "/assets.pak";
+        if (!QFile::exists(path))
+            return;
+    }
+
+    QString error;
+    if (AssetCache::instance().mountArchive(path, root, &error))
+        qDebug() << "[main] Assets from" << path;
+    else
+        qWarning() << "[main] Using loose asset files:" << error;
+}
 
 int main(int argc, char *argv[])
 {
+    if (wantsHeadless(argc, argv))
+        return runHeadlessMode(argc, argv);
+    if (wantsPackAssets(argc, argv))
+        return runPackAssets(argc, argv);
+
     QApplication app(argc, argv);
+    LaunchOptions options = parseLaunchOptions(app);
+    mountAssets(options);
+
+    if (options.benchRender)
+        return runRenderBenchMode();
+
+    // Chunks stream in asynchronously and a missing one reads as wall, so
+    // open-world collisions depend on load timing and cannot be replayed
+    if (options.openWorld && (!options.recordPath.isEmpty() || !options.replayPath.isEmpty())) {
+        QTextStream(stderr) << "error: --record and --replay cannot be used with --open-world\n";
+        return 1;
+    }
 
-    StartMenu menu;
+    StartMenu menu(options);
     menu.show();
 
     return app.exec();
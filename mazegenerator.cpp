@@ -4,8 +4,15 @@
 #include <algorithm>
 
 MazeGenerator::MazeGenerator(int rows, int cols)
+    : MazeGenerator(rows, cols, QRandomGenerator::global()->generate())
+{
+}
+
+MazeGenerator::MazeGenerator(int rows, int cols, quint32 seed)
     : m_rowsCells(rows),
-    m_colsCells(cols)
+    m_colsCells(cols),
+    m_seed(seed),
+    m_rng(seed)
 {
     // Coarse grid: odd cells are passages, even are walls
     m_gridRows = 2 * m_rowsCells + 1;
@@ -21,7 +28,7 @@ MazeGenerator::MazeData MazeGenerator::generate()
 
     // 2) pick exit on TOP of coarse maze (row 1, near left/right)
     m_exitRowCoarse = 1;
-    bool exitOnLeft = (QRandomGenerator::global()->bounded(2) == 0);
+    bool exitOnLeft = (m_rng.bounded(2) == 0);
     m_exitColCoarse = exitOnLeft ? 1 : (m_gridCols - 2);
 
     m_grid[m_exitRowCoarse][m_exitColCoarse] = 0;
@@ -155,11 +162,51 @@ MazeGenerator::MazeData MazeGenerator::generate()
     data.exit  = exitFine;
     data.doors = doorFine;
     data.keys  = keyFine;
+    data.scale = scale;
+    data.seed  = m_seed;
     return data;
 }
 
 
 
+MazeGenerator::MazeData MazeGenerator::generateChunk(int chunkX, int chunkY, int size,
+                                                     quint32 worldSeed)
+{
+    auto chunkSeed = [&](quint32 salt) {
+        quint32 h = worldSeed ^ (salt * 0x9e3779b9u);
+        h = (h ^ quint32(chunkX)) * 0x85ebca6bu;
+        h = (h ^ quint32(chunkY)) * 0xc2b2ae35u;
+        return h ^ (h >> 16);
+    };
+
+    MazeGenerator gen(size, size, chunkSeed(0));
+    gen.carveFrom(1, 1);
+
+    // The east and south walls belong to the neighbours
+    gen.m_grid.pop_back();
+    for (auto &row : gen.m_grid)
+        row.pop_back();
+    gen.m_gridRows = 2 * size;
+    gen.m_gridCols = 2 * size;
+
+    // Openings at odd positions line up with the passages on both sides
+    QRandomGenerator north(chunkSeed(1));
+    QRandomGenerator west(chunkSeed(2));
+    gen.m_grid[0][2 * north.bounded(size) + 1] = 0;
+    gen.m_grid[2 * west.bounded(size) + 1][0]  = 0;
+
+    const int scale = 2;
+    gen.widenGrid(scale);
+
+    MazeData data;
+    data.grid  = std::move(gen.m_grid);
+    data.start = { scale, scale };
+    data.exit  = data.start;
+    data.scale = scale;
+    data.seed  = gen.m_seed;
+    return data;
+}
+
 void MazeGenerator::widenGrid(int scale)
 {
     int newRows = m_gridRows * scale;
@@ -200,7 +247,7 @@ void MazeGenerator::carveFrom(int r, int c)
 
     int n = int(dirs.size());
     for (int i = 0; i < n; ++i) {
-        int j = QRandomGenerator::global()->bounded(i, n);
+        int j = m_rng.bounded(i, n);
         std::swap(dirs[i], dirs[j]);
     }
 
@@ -2,6 +2,7 @@
 #define MAZEGENERATOR_H
 
 #include <vector>
+#include <QRandomGenerator>
 
 class MazeGenerator {
 public:
@@ -16,12 +17,23 @@ public:
         Cell exit;
         std::vector<Cell> doors;             // door positions (fine grid, top-left of 2x2)
         std::vector<Cell> keys;              // key positions (fine grid)
+        int scale = 2;                       // fine cells per coarse cell
+        quint32 seed = 0;                    // same seed -> same maze
     };
 
     MazeGenerator(int rows, int cols);
+    MazeGenerator(int rows, int cols, quint32 seed);
 
     MazeData generate();
 
+    // One chunk of an endless maze, `size` coarse cells square, fixed by
+    // the world seed and the chunk position. A chunk owns its north and
+    // west walls and opens each at a spot derived from that wall alone, so
+    // neighbours always join up without knowing each other. The fine grid
+    // is 4 * size cells square; start is its first passage cell. No exit,
+    // doors or keys.
+    static MazeData generateChunk(int chunkX, int chunkY, int size, quint32 worldSeed);
+
 private:
     void carveFrom(int r, int c);
     void widenGrid(int scale);
@@ -37,6 +49,9 @@ private:
 
     int m_exitRowCoarse;
     int m_exitColCoarse;
+
+    quint32          m_seed;
+    QRandomGenerator m_rng;
 };
 
 #endif // MAZEGENERATOR_H
@@ -0,0 +1,129 @@
+#include "minimap.h"
+#include "frameprofiler.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+namespace {
+
+const QRgb kUnexplored = qRgba(0, 0, 0, 150);
+const QRgb kWall       = qRgba(110, 110, 125, 220);
+const QRgb kFloor      = qRgba(35, 35, 40, 220);
+const QRgb kDoor       = qRgba(170, 110, 40, 230);
+const QRgb kExit       = qRgba(60, 200, 90, 230);
+
+} // namespace
+
+Minimap::Minimap(QWidget *parent)
+    : QWidget(parent)
+{
+    // Purely informational: never steal input from the game view
+    setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    setFocusPolicy(Qt::NoFocus);
+    hide();
+}
+
+void Minimap::setLevel(const MazeGenerator::MazeData &maze)
+{
+    m_maze = maze;
+    m_exit = QRect(maze.exit.c, maze.exit.r, maze.scale, maze.scale);
+
+    const int rows = int(maze.grid.size());
+    const int cols = rows ? int(maze.grid[0].size()) : 0;
+    m_explored = QBitArray(rows * cols);
+    m_image = QImage(cols * kCellPixels, rows * kCellPixels, QImage::Format_ARGB32);
+    m_image.fill(kUnexplored);
+    m_playerCell = QPoint(-1, -1);
+
+    // Top-right corner of the view
+    if (QWidget *view = parentWidget())
+        setGeometry(view->width() - m_image.width() - 4, 4, m_image.width(), m_image.height());
+    update();
+}
+
+void Minimap::setPlayerCell(const QPoint &cell)
+{
+    if (cell == m_playerCell || m_explored.isEmpty())
+        return;
+
+    PROFILE_SCOPE("minimap");
+
+    const QPoint old = m_playerCell;
+    m_playerCell = cell;
+
+    const int r2 = kRevealRadius * kRevealRadius;
+    for (int dr = -kRevealRadius; dr <= kRevealRadius; ++dr) {
+        for (int dc = -kRevealRadius; dc <= kRevealRadius; ++dc) {
+            if (dr * dr + dc * dc <= r2)
+                reveal(cell.y() + dr, cell.x() + dc);
+        }
+    }
+
+    // Only the area around the old and new marker changes on screen
+    const int extent = (2 * kRevealRadius + 1) * kCellPixels;
+    auto around = [&](const QPoint &c) {
+        return QRect((c.x() - kRevealRadius) * kCellPixels,
+                     (c.y() - kRevealRadius) * kCellPixels, extent, extent);
+    };
+    update(around(cell));
+    if (old.x() >= 0)
+        update(around(old));
+}
+
+void Minimap::reveal(int row, int col)
+{
+    const int rows = int(m_maze.grid.size());
+    const int cols = int(m_maze.grid[0].size());
+    if (row < 0 || col < 0 || row >= rows || col >= cols)
+        return;
+
+    const int bit = row * cols + col;
+    if (m_explored.testBit(bit))
+        return;
+    m_explored.setBit(bit);
+    paintCell(row, col);
+}
+
+void Minimap::openDoor(const QRect &cells)
+{
+    const int rows = int(m_maze.grid.size());
+    const int cols = rows ? int(m_maze.grid[0].size()) : 0;
+
+    for (int row = qMax(0, cells.top()); row <= qMin(rows - 1, cells.bottom()); ++row) {
+        for (int col = qMax(0, cells.left()); col <= qMin(cols - 1, cells.right()); ++col) {
+            if (m_maze.grid[row][col] != 2)
+                continue;
+            m_maze.grid[row][col] = 0;
+
+            // Unexplored cells get the new colour when they are revealed
+            if (m_explored.testBit(row * cols + col))
+                paintCell(row, col);
+        }
+    }
+    update(QRect(cells.topLeft() * kCellPixels, cells.size() * kCellPixels));
+}
+
+void Minimap::paintCell(int row, int col)
+{
+    QRgb color = kFloor;
+    if (m_exit.contains(col, row))
+        color = kExit;
+    else if (m_maze.grid[row][col] == 1)
+        color = kWall;
+    else if (m_maze.grid[row][col] == 2)
+        color = kDoor;
+
+    for (int y = 0; y < kCellPixels; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(m_image.scanLine(row * kCellPixels + y));
+        for (int x = 0; x < kCellPixels; ++x)
+            line[col * kCellPixels + x] = color;
+    }
+}
+
+void Minimap::paintEvent(QPaintEvent *event)
+{
+    QPainter p(this);
+    p.drawImage(event->rect().topLeft(), m_image, event->rect());
+    p.fillRect(m_playerCell.x() * kCellPixels - 1, m_playerCell.y() * kCellPixels - 1,
+               kCellPixels + 2, kCellPixels + 2, Qt::yellow);
+}
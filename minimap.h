@@ -0,0 +1,51 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include <QBitArray>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QWidget>
+
+#include "mazegenerator.h"
+
+// Corner map of the level, drawn from the maze grid rather than as a second
+// view of the scene. Cells are explored around the player as they walk; an
+// explored bit per cell means each cell is drawn into the cached image
+// once, the moment it is revealed (and again if a door on it opens), so
+// the cost of a frame depends on the newly explored cells only, never on
+// the size of the maze.
+class Minimap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kCellPixels   = 2;
+    static constexpr int kRevealRadius = 4;   // cells around the player
+
+    explicit Minimap(QWidget *parent = nullptr);
+
+    // New level: everything unexplored again
+    void setLevel(const MazeGenerator::MazeData &maze);
+
+    // Grid cell of the player's feet; explores around it when it changes
+    void setPlayerCell(const QPoint &cell);
+
+    // Grid cells of a door that was unlocked; drawn as floor from now on
+    void openDoor(const QRect &cells);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void reveal(int row, int col);
+    void paintCell(int row, int col);
+
+    MazeGenerator::MazeData m_maze;
+    QRect                   m_exit;   // grid cells
+    QBitArray               m_explored;
+    QImage                  m_image;   // one kCellPixels square per cell
+    QPoint                  m_playerCell { -1, -1 };
+};
+
+#endif // MINIMAP_H
@@ -1,78 +1,62 @@
 #include "monsteritem.h"
 
-#include <QGraphicsRectItem>
-#include <QPen>
-#include <QBrush>
+#include <QGraphicsScene>
 
-MonsterItem::MonsterItem(MonsterType type,
-                         const QPixmap &sprite,
-                         int maxHp,
-                         int cellSize,
+MonsterItem::MonsterItem(const QPixmap &sprite,
                          QGraphicsItem *parent)
     : QObject(),
-    QGraphicsPixmapItem(parent),
-    m_type(type),
-    m_maxHp(maxHp),
-    m_hp(maxHp),
-    m_cellSize(cellSize),
-    m_speed(4.0),
-    m_hpBg(nullptr),
-    m_hpFg(nullptr)
+    QGraphicsPixmapItem(parent)
 {
     setPixmap(sprite);
     setZValue(0.15); // Above floor/walls, slightly below player
+}
 
-    if (m_type == DamageMonster)
-        m_speed = 3.0;
-    else
-        m_speed = 6.0;   // Slow-monster is actually faster
-
-    // ---- Create health bar ----
-    qreal barWidth  = cellSize;
-    qreal barHeight = 4.0;
-
-    m_hpBg = new QGraphicsRectItem(0, 0, barWidth, barHeight, this);
-    m_hpBg->setBrush(QBrush(Qt::red));
-    m_hpBg->setPen(Qt::NoPen);
-
-    m_hpFg = new QGraphicsRectItem(0, 0, barWidth, barHeight, this);
-    m_hpFg->setBrush(QBrush(Qt::green));
-    m_hpFg->setPen(Qt::NoPen);
+void MonsterItem::reset(const QPixmap &sprite)
+{
+    setPixmap(sprite);
+    show();
+}
 
-    // Place health bar above the monster’s head
+void MonsterItem::setFeetPos(const QPointF &feet)
+{
     QRectF b = boundingRect();
-    Q_UNUSED(b);
-    qreal y = -barHeight - 2.0;
-    qreal x = -barWidth / 2.0;
-    m_hpBg->setPos(x, y);
-    m_hpFg->setPos(x, y);
-
-    updateHealthBar();
+    setPos(feet.x() - b.width() / 2.0, feet.y() - b.height());
 }
 
-void MonsterItem::takeDamage(int amount)
+void MonsterPool::moveTo(QGraphicsScene *scene)
 {
-    if (amount <= 0 || m_hp <= 0)
-        return;
-
-    m_hp -= amount;
-    if (m_hp < 0)
-        m_hp = 0;
-
-    updateHealthBar();
+    m_scene = scene;
+    for (MonsterItem *item : m_all) {
+        if (item->scene())
+            item->scene()->removeItem(item);
+        scene->addItem(item);
+    }
 }
 
-void MonsterItem::updateHealthBar()
+void MonsterPool::reserve(int count)
 {
-    if (!m_hpFg)
-        return;
+    while (m_free.size() < count) {
+        auto *item = new MonsterItem(QPixmap());
+        item->hide();
+        if (m_scene)
+            m_scene->addItem(item);
+        m_all.append(item);
+        m_free.append(item);
+    }
+}
 
-    qreal ratio = (m_maxHp > 0) ? (qreal)m_hp / (qreal)m_maxHp : 0.0;
-    if (ratio < 0.0)
-        ratio = 0.0;
+MonsterItem *MonsterPool::acquire(const QPixmap &sprite)
+{
+    if (m_free.isEmpty())
+        reserve(1);
 
-    qreal fullWidth = m_cellSize;
-    qreal barHeight = m_hpFg->rect().height();
+    MonsterItem *item = m_free.takeLast();
+    item->reset(sprite);
+    return item;
+}
 
-    m_hpFg->setRect(0, 0, fullWidth * ratio, barHeight);
+void MonsterPool::release(MonsterItem *item)
+{
+    item->hide();
+    m_free.append(item);
 }
@@ -3,44 +3,48 @@
 
 #include <QObject>
 #include <QGraphicsPixmapItem>
+#include <QVector>
 
-class QGraphicsRectItem;
+class QGraphicsScene;
 
+// Visual for one simulated monster. Behaviour lives in GameSimulation; the
+// health bar is part of the HUD (GameView::drawForeground).
 class MonsterItem : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
 public:
-    enum MonsterType {
-        DamageMonster, // damage
-        SlowMonster    // Slow
-    };
-
-    explicit MonsterItem(MonsterType type,
-                         const QPixmap &sprite,
-                         int maxHp,
-                         int cellSize,
+    explicit MonsterItem(const QPixmap &sprite,
                          QGraphicsItem *parent = nullptr);
 
-    // Do not call to avoid conflict
-    MonsterType monsterType() const { return m_type; }
+    // Shown again with a new sprite, e.g. when taken from the pool
+    void reset(const QPixmap &sprite);
 
-    void takeDamage(int amount);
-    bool isDead() const { return m_hp <= 0; }
+    // Place the sprite so its bottom-centre ("feet") is at `feet`
+    void setFeetPos(const QPointF &feet);
+};
+
+// Reusable monster items. Released items are hidden instead of deleted and
+// handed out again by acquire(), so spawn waves allocate nothing once the
+// pool is warm. Every item lives in the pool's current scene, which owns it.
+class MonsterPool
+{
+public:
+    // Take every item, live or free, over into `scene` (level swap);
+    // live ones must have been released first
+    void moveTo(QGraphicsScene *scene);
 
-    qreal speed() const { return m_speed; }
-    void  setSpeed(qreal s) { m_speed = s; }
+    // Create hidden items until at least `count` are free
+    void reserve(int count);
 
-private:
-    void updateHealthBar();
+    MonsterItem *acquire(const QPixmap &sprite);
+    void release(MonsterItem *item);
 
-    MonsterType m_type;
-    int m_maxHp;
-    int m_hp;
-    int m_cellSize;
-    qreal m_speed;
+    int size() const { return m_all.size(); }
 
-    QGraphicsRectItem *m_hpBg;
-    QGraphicsRectItem *m_hpFg;
+private:
+    QGraphicsScene       *m_scene = nullptr;
+    QVector<MonsterItem*> m_all;
+    QVector<MonsterItem*> m_free;
 };
 
 #endif // MONSTERITEM_H
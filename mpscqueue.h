@@ -0,0 +1,74 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for any number of producer threads and exactly
+// one consumer thread (per-slot sequence numbers, after D. Vyukov).
+// Capacity must be a power of two; push() fails when full.
+template <typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue capacity must be a power of two");
+
+public:
+    MpscQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Any thread
+    bool push(const T &value)
+    {
+        std::size_t pos = m_enqueue.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &m_cells[pos & (Capacity - 1)];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+            if (diff == 0) {
+                if (m_enqueue.compare_exchange_weak(pos, pos + 1,
+                                                    std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool pop(T &value)
+    {
+        Cell &cell = m_cells[m_dequeue & (Capacity - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != m_dequeue + 1)
+            return false;
+
+        value = cell.value;
+        cell.seq.store(m_dequeue + Capacity, std::memory_order_release);
+        ++m_dequeue;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T                        value;
+    };
+
+    Cell m_cells[Capacity];
+
+    alignas(64) std::atomic<std::size_t> m_enqueue{0};
+    alignas(64) std::size_t              m_dequeue = 0;
+};
+
+#endif // MPSCQUEUE_H
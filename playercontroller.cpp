@@ -1,156 +1,81 @@
 #include "playercontroller.h"
-#include "playeritem.h"
+#include "inputclock.h"
+#include "inputstate.h"
 
 #include <QKeyEvent>
 
-PlayerController::PlayerController(int step)
-    : m_player(nullptr),
-    m_moveLeft(false),
-    m_moveRight(false),
-    m_moveUp(false),
-    m_moveDown(false),
-    m_step(step)
-{
-}
+namespace {
 
-void PlayerController::setPlayer(PlayerItem *player)
+quint8 buttonForKey(int key)
 {
-    m_player = player;
-    reset();
+    switch (key) {
+    case Qt::Key_Left:  return InputState::Left;
+    case Qt::Key_Right: return InputState::Right;
+    case Qt::Key_Up:    return InputState::Up;
+    case Qt::Key_Down:  return InputState::Down;
+    case Qt::Key_Space: return InputState::Attack;   // attack in current direction
+    default:            return 0;
+    }
 }
 
-void PlayerController::setStep(int step)
+quint8 oppositeOf(quint8 button)
 {
-    m_step = step;
+    switch (button) {
+    case InputState::Left:  return InputState::Right;
+    case InputState::Right: return InputState::Left;
+    case InputState::Up:    return InputState::Down;
+    case InputState::Down:  return InputState::Up;
+    default:                return 0;
+    }
 }
 
-void PlayerController::reset()
-{
-    m_moveLeft  = false;
-    m_moveRight = false;
-    m_moveUp    = false;
-    m_moveDown  = false;
+} // namespace
 
-    if (m_player)
-        m_player->setAction(PlayerItem::Idle);
+PlayerController::PlayerController()
+    : m_held(0)
+{
 }
 
 bool PlayerController::handleKeyPress(QKeyEvent *event)
 {
-    if (!m_player)
-        return false;
-
-    if (m_player->action() == PlayerItem::Dying) {
-        event->ignore();
-        return true;    // we consumed it, but no movement
-    }
-
     if (event->isAutoRepeat()) {
         event->ignore();
         return true;
     }
 
-    bool handled = true;
-
-    switch (event->key()) {
-    case Qt::Key_Left:
-        m_moveLeft  = true;
-        m_moveRight = false;
-        m_player->setDirection(PlayerItem::Left);
-        m_player->setAction(PlayerItem::Run);
-        break;
-
-    case Qt::Key_Right:
-        m_moveRight = true;
-        m_moveLeft  = false;
-        m_player->setDirection(PlayerItem::Right);
-        m_player->setAction(PlayerItem::Run);
-        break;
-
-    case Qt::Key_Up:
-        m_moveUp   = true;
-        m_moveDown = false;
-        m_player->setDirection(PlayerItem::Back);
-        m_player->setAction(PlayerItem::Run);
-        break;
-
-    case Qt::Key_Down:
-        m_moveDown = true;
-        m_moveUp   = false;
-        m_player->setDirection(PlayerItem::Front);
-        m_player->setAction(PlayerItem::Run);
-        break;
+    const quint8 button = buttonForKey(event->key());
+    if (!button)
+        return false;
 
-    case Qt::Key_Space:
-        // Attack in current direction; no movement state change
-        m_player->setAction(PlayerItem::Attack);
-        break;
+    const qint64 now = inputClockNs();
 
-    default:
-        handled = false;
-        break;
+    // The newest direction on an axis wins over the opposite key
+    const quint8 opposite = oppositeOf(button) & m_held;
+    if (opposite) {
+        m_held &= quint8(~opposite);
+        push(InputEvent::Release, opposite, now);
     }
 
-    return handled;
+    m_held |= button;
+    push(InputEvent::Press, button, now);
+    return true;
 }
 
 bool PlayerController::handleKeyRelease(QKeyEvent *event)
 {
-    if (!m_player)
-        return false;
-
-    if (m_player->action() == PlayerItem::Dying) {
-        event->ignore();
-        return true;
-    }
-
     if (event->isAutoRepeat()) {
         event->ignore();
         return true;
     }
 
-    bool handled = true;
+    const quint8 button = buttonForKey(event->key());
+    if (!button)
+        return false;
 
-    switch (event->key()) {
-    case Qt::Key_Left:
-        m_moveLeft = false;
-        break;
-    case Qt::Key_Right:
-        m_moveRight = false;
-        break;
-    case Qt::Key_Up:
-        m_moveUp = false;
-        break;
-    case Qt::Key_Down:
-        m_moveDown = false;
-        break;
-    default:
-        handled = false;
-        break;
+    // Already released when the opposite key took over
+    if (m_held & button) {
+        m_held &= quint8(~button);
+        push(InputEvent::Release, button, inputClockNs());
     }
-
-    if (!isMoving() && m_player)
-        m_player->setAction(PlayerItem::Idle);
-
-    return handled;
-}
-
-QPointF PlayerController::movementDelta() const
-{
-    QPointF delta(0, 0);
-
-    if (!m_player)
-        return delta;
-
-    if (m_moveLeft)  delta.rx() -= m_step;
-    if (m_moveRight) delta.rx() += m_step;
-    if (m_moveUp)    delta.ry() -= m_step;
-    if (m_moveDown)  delta.ry() += m_step;
-
-    return delta;
-}
-
-bool PlayerController::isMoving() const
-{
-    return m_moveLeft || m_moveRight || m_moveUp || m_moveDown;
+    return true;
 }
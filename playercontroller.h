@@ -1,34 +1,22 @@
 #ifndef PLAYERCONTROLLER_H
 #define PLAYERCONTROLLER_H
 
-#include <QPointF>
+#include "inputbackend.h"
 
-class QKeyEvent;
-class PlayerItem;
-
-class PlayerController
+// Keyboard input backend: arrow keys move, space attacks
+class PlayerController : public InputBackend
 {
 public:
-    explicit PlayerController(int step = 15);
+    PlayerController();
 
-    void setPlayer(PlayerItem *player);
-    void setStep(int step);
+    const char *name() const override { return "keyboard"; }
 
     // return true if event handled
-    bool handleKeyPress(QKeyEvent *event);
-    bool handleKeyRelease(QKeyEvent *event);
-
-    QPointF movementDelta() const;
-    bool isMoving() const;
-    void reset();
+    bool handleKeyPress(QKeyEvent *event) override;
+    bool handleKeyRelease(QKeyEvent *event) override;
 
 private:
-    PlayerItem *m_player;
-    bool m_moveLeft;
-    bool m_moveRight;
-    bool m_moveUp;
-    bool m_moveDown;
-    int  m_step;
+    quint8 m_held;   // keys this backend reported as down
 };
 
 #endif // PLAYERCONTROLLER_H
@@ -1,157 +1,153 @@
 #include "playeritem.h"
-#include <QDir>
 #include <QDebug>
 
-PlayerItem::PlayerItem(const QString &spriteRoot,
-                       int tileSize,
-                       QGraphicsItem *parent)
-    : QObject(),
-    QGraphicsPixmapItem(parent),
-    m_spriteRoot(spriteRoot),
-    m_tileSize(tileSize),
-    m_scaleComputed(false),
-    m_direction(Front),
-    m_action(Idle)
+const QVector<PlayerSprites::Spec> &PlayerSprites::specs()
 {
-    // Centered transform origin (useful if you add rotations later)
-    setTransformOriginPoint(boundingRect().center());
-
-    // ---- Load all animations from disk (NOT resources) ----
-    addAnimation("front_idle",   m_spriteRoot + "/Front_Idle",      6);
-    addAnimation("front_walk",   m_spriteRoot + "/Front_Walking",   10);
-    addAnimation("front_run",    m_spriteRoot + "/Front_Running",   14);
-    addAnimation("front_attack", m_spriteRoot + "/Front_Attacking", 12);
-
-    addAnimation("back_idle",    m_spriteRoot + "/Back_Idle",       6);
-    addAnimation("back_walk",    m_spriteRoot + "/Back_Walking",    10);
-    addAnimation("back_run",     m_spriteRoot + "/Back_Running",    11);
-    addAnimation("back_attack",  m_spriteRoot + "/Back_Attacking",  12);
-
-    addAnimation("left_idle",    m_spriteRoot + "/Left_Idle",       6);
-    addAnimation("left_walk",    m_spriteRoot + "/Left_Walking",    10);
-    addAnimation("left_run",     m_spriteRoot + "/Left_Running",    14);
-    addAnimation("left_attack",  m_spriteRoot + "/Left_Attacking",  12);
-
-    addAnimation("right_idle",   m_spriteRoot + "/Right_Idle",      6);
-    addAnimation("right_walk",   m_spriteRoot + "/Right_Walking",   10);
-    addAnimation("right_run",    m_spriteRoot + "/Right_Running",   14);
-    addAnimation("right_attack", m_spriteRoot + "/Right_Attacking", 12);
-
-    addAnimation("dying",        m_spriteRoot + "/Dying",           8);
-
-    // Default: front idle
-    setAnimation("front_idle");
+    // Slot order: idle, walk, run, attack per direction, then dying
+    static const QVector<Spec> list = {
+        { "Front_Idle",       6 },
+        { "Front_Walking",   10 },
+        { "Front_Running",   14 },
+        { "Front_Attacking", 12 },
+
+        { "Back_Idle",        6 },
+        { "Back_Walking",    10 },
+        { "Back_Running",    11 },
+        { "Back_Attacking",  12 },
+
+        { "Left_Idle",        6 },
+        { "Left_Walking",    10 },
+        { "Left_Running",    14 },
+        { "Left_Attacking",  12 },
+
+        { "Right_Idle",       6 },
+        { "Right_Walking",   10 },
+        { "Right_Running",   14 },
+        { "Right_Attacking", 12 },
+
+        { "Dying",            8 }
+    };
+    Q_ASSERT(list.size() == kSlots);
+    return list;
+}
 
-    connect(&m_timer, &QTimer::timeout, this, &PlayerItem::nextFrame);
+QStringList PlayerSprites::framePaths(const QString &folder)
+{
+    const QStringList paths = AssetCache::instance().imageFiles(folder);
+    if (paths.isEmpty())
+        qWarning() << "[PlayerItem] No frames in:" << folder;
+    return paths;
 }
 
-QVector<QPixmap> PlayerItem::loadFrames(const QString &folder)
+AssetRequest PlayerSprites::frameRequest(const QString &path, qreal scale)
 {
-    QVector<QPixmap> frames;
+    AssetRequest req;
+    req.path  = path;
+    req.scale = scale * 2;
+    req.mode  = Qt::KeepAspectRatio;
+    return req;
+}
 
-    QDir dir(folder);
-    if (!dir.exists()) {
-        qWarning() << "[PlayerItem] Folder does not exist:" << folder;
-        return frames;
-    }
+qreal PlayerSprites::frameScale(const QString &spriteRoot, int tileSize)
+{
+    // Width of the first frame of the first animation
+    const QString folder = spriteRoot + "/" + specs().first().folder;
+    const QStringList files = framePaths(folder);
+    if (files.isEmpty())
+        return 0.8;
+
+    int originalWidth = AssetCache::instance().imageSize(files.first()).width();
+    return originalWidth > 0 ? qreal(tileSize) / originalWidth : 0.8;
+}
 
-    dir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
-    dir.setNameFilters(QStringList() << "*.png" << "*.PNG");
-    dir.setSorting(QDir::Name | QDir::IgnoreCase);
+QVector<QImage> PlayerSprites::loadFrames(const QString &folder, qreal scale)
+{
+    QVector<QImage> frames;
 
-    const QStringList files = dir.entryList();
-    for (const QString &file : files) {
-        QString path = folder + "/" + file;
-        QPixmap pix(path);
-        if (pix.isNull()) {
+    const QStringList paths = framePaths(folder);
+    for (const QString &path : paths) {
+        QImage img = AssetCache::instance().image(frameRequest(path, scale));
+        if (img.isNull()) {
             qWarning() << "[PlayerItem] Could not load frame:" << path;
             continue;
         }
-        if (!m_scaleComputed) {
-
-            int originalWidth = pix.width();   // width of first frame
-
-            if (originalWidth > 0) {
-                m_scale = (float)m_tileSize / (float)originalWidth;
-                m_scaleComputed = true;
-            }
-        }
-        if (m_scale != 1.0f) {
-            int newW = pix.width()  * m_scale * 2;
-            int newH = pix.height() * m_scale * 2;
-
-            pix = pix.scaled(newW,
-                             newH,
-                             Qt::KeepAspectRatio,
-                             Qt::SmoothTransformation);
-        }
-
-        frames.push_back(pix);
+        frames.push_back(img);
     }
 
     return frames;
 }
 
-void PlayerItem::addAnimation(const QString &key,
-                              const QString &folderOnDisk,
-                              int fps)
+PlayerSprites PlayerSprites::load(const QString &spriteRoot, int tileSize)
 {
-    Animation anim;
-    anim.frames = loadFrames(folderOnDisk);
-    anim.fps    = fps;
+    PlayerSprites sprites;
+    const qreal scale = frameScale(spriteRoot, tileSize);
 
-    if (!anim.frames.isEmpty())
-        m_animations.insert(key, anim);
+    for (int i = 0; i < kSlots; ++i) {
+        const Spec &spec = specs()[i];
+        sprites.animations[i].frames = loadFrames(spriteRoot + "/" + spec.folder, scale);
+        sprites.animations[i].fps    = spec.fps;
+    }
+    return sprites;
 }
 
-QString PlayerItem::keyFor(Direction d, Action a) const
+bool PlayerSprites::isEmpty() const
 {
-    QString dirStr;
-    switch (d) {
-    case Front: dirStr = "front"; break;
-    case Back:  dirStr = "back";  break;
-    case Left:  dirStr = "left";  break;
-    case Right: dirStr = "right"; break;
+    for (const Animation &anim : animations) {
+        if (!anim.frames.isEmpty())
+            return false;
     }
+    return true;
+}
+
+PlayerItem::PlayerItem(const QString &spriteRoot,
+                       int tileSize,
+                       QGraphicsItem *parent)
+    : PlayerItem(PlayerSprites::load(spriteRoot, tileSize), parent)
+{
+}
 
-    if (a == Dying)
-        return "dying";
+PlayerItem::PlayerItem(const PlayerSprites &sprites,
+                       QGraphicsItem *parent)
+    : QGraphicsPixmapItem(parent),
+    m_direction(Front),
+    m_action(Idle)
+{
+    // Centered transform origin (useful if you add rotations later)
+    setTransformOriginPoint(boundingRect().center());
 
-    QString actStr;
-    switch (a) {
-    case Idle:   actStr = "idle";   break;
-    case Walk:   actStr = "walk";   break;
-    case Run:    actStr = "run";    break;
-    case Attack: actStr = "attack"; break;
-    case Dying:  actStr = "dying";  break;
+    for (int i = 0; i < kSlots && i < sprites.animations.size(); ++i) {
+        m_animations[i].fps = sprites.animations[i].fps;
+        for (const QImage &img : sprites.animations[i].frames)
+            m_animations[i].frames.push_back(AssetCache::instance().pixmap(img));
     }
 
-    return dirStr + "_" + actStr; // e.g. "front_walk"
+    // Default: front idle
+    setAnimation(slot(Front, Idle));
+}
+
+void PlayerItem::setClock(AnimationClock *clock)
+{
+    m_clock = clock;
+    setAnimation(m_slot);
 }
 
-void PlayerItem::setAnimation(const QString &key)
+void PlayerItem::setAnimation(int index)
 {
-    if (!m_animations.contains(key)) {
-        qWarning() << "[PlayerItem] Unknown animation key:" << key;
+    const Animation &anim = m_animations[index];
+    if (anim.frames.isEmpty()) {
+        qWarning() << "[PlayerItem] No frames for animation"
+                   << PlayerSprites::specs()[index].folder;
         return;
     }
 
-    m_currentKey = key;
+    m_slot       = index;
     m_frameIndex = 0;
+    m_startNs    = m_clock ? m_clock->now() : 0;
+    setPixmap(anim.frames[0]);
 
-    Animation &anim = m_animations[m_currentKey];
-    if (!anim.frames.isEmpty()) {
-        setPixmap(anim.frames[0]);
-
-        if (anim.fps > 0) {
-            // Global speed tweak: change 1000 to 500 for 2x speed, etc.
-            m_timer.start(1000 / anim.fps);
-        } else {
-            m_timer.stop();
-        }
-    } else {
-        m_timer.stop();
-    }
+    // Still frames never need the clock
+    if (m_clock && anim.frames.size() > 1 && anim.fps > 0)
+        m_clock->play(this);
 }
 
 void PlayerItem::setDirection(Direction dir)
@@ -160,7 +156,7 @@ void PlayerItem::setDirection(Direction dir)
         return;
 
     m_direction = dir;
-    setAnimation(keyFor(m_direction, m_action));
+    setAnimation(slot(m_direction, m_action));
 }
 
 void PlayerItem::setAction(Action act)
@@ -169,36 +165,32 @@ void PlayerItem::setAction(Action act)
         return;
 
     m_action = act;
-    setAnimation(keyFor(m_direction, m_action));
+    setAnimation(slot(m_direction, m_action));
 }
 
-void PlayerItem::nextFrame()
+bool PlayerItem::advanceAnimation(qint64 nowNs)
 {
-    if (m_currentKey.isEmpty())
-        return;
-
-    Animation &anim = m_animations[m_currentKey];
-    if (anim.frames.isEmpty())
-        return;
+    const Animation &anim = m_animations[m_slot];
+    if (anim.frames.size() <= 1 || anim.fps <= 0)
+        return false;
 
-    m_frameIndex++;
+    int frame = int((nowNs - m_startNs) * anim.fps / 1000000000);
 
     if (m_action == Attack) {
-        // Attack plays once: stop at last frame
-        if (m_frameIndex >= anim.frames.size()) {
-            m_frameIndex = anim.frames.size() - 1;
-            setPixmap(anim.frames[m_frameIndex]);
-            m_timer.stop();
-
-            // return to Idle after attack finishes
+        // Attack plays once, then back to idle
+        if (frame >= anim.frames.size()) {
             m_action = Idle;
-            setAnimation(keyFor(m_direction, m_action));
-            return;
+            setAnimation(slot(m_direction, m_action));
+            return m_slot == slot(m_direction, m_action);
         }
     } else {
         // Normal looping animations
-        m_frameIndex %= anim.frames.size();
+        frame %= anim.frames.size();
     }
 
-    setPixmap(anim.frames[m_frameIndex]);
+    if (frame != m_frameIndex) {
+        m_frameIndex = frame;
+        setPixmap(anim.frames[frame]);
+    }
+    return true;
 }
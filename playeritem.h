@@ -1,23 +1,73 @@
 #ifndef PLAYERITEM_H
 #define PLAYERITEM_H
 
-#include <QObject>
 #include <QGraphicsPixmapItem>
-#include <QMap>
+#include <QImage>
 #include <QVector>
 #include <QPixmap>
-#include <QTimer>
 
-class PlayerItem : public QObject, public QGraphicsPixmapItem
+#include "animationclock.h"
+#include "assetcache.h"
+
+// Direction x action of the player's animations
+struct PlayerPose
 {
-    Q_OBJECT
-public:
     enum Direction { Front, Back, Left, Right };
     enum Action    { Idle, Walk, Run, Attack, Dying };
 
+    // Animation table: four actions per direction, then the one dying
+    // animation every direction shares
+    static constexpr int kSlots = 4 * 4 + 1;
+    static int slot(Direction d, Action a)
+    {
+        return a == Dying ? kSlots - 1 : int(d) * 4 + int(a);
+    }
+};
+
+// Decoded, scaled animation frames of one character. Plain QImages, so it
+// can be loaded on a worker thread; PlayerItem turns them into pixmaps.
+struct PlayerSprites : PlayerPose
+{
+    struct Animation {
+        QVector<QImage> frames;
+        int fps = 8;
+    };
+
+    // One animation folder below the character's sprite root, in slot order
+    struct Spec {
+        const char *folder;   // e.g. "Front_Walking"
+        int         fps;
+    };
+    static const QVector<Spec> &specs();
+
+    // Scale that fits the first idle frame to one tile
+    static qreal frameScale(const QString &spriteRoot, int tileSize);
+
+    // Frame files of one folder in playback order
+    static QStringList framePaths(const QString &folder);
+    static AssetRequest frameRequest(const QString &path, qreal scale);
+    static QVector<QImage> loadFrames(const QString &folder, qreal scale);
+
+    // Sequential load of every animation
+    static PlayerSprites load(const QString &spriteRoot, int tileSize);
+
+    bool isEmpty() const;
+
+    QVector<Animation> animations = QVector<Animation>(kSlots);   // by slot()
+};
+
+// Player sprite; frames are advanced by an AnimationClock
+class PlayerItem : public QGraphicsPixmapItem, public PlayerPose, public Animated
+{
+public:
     explicit PlayerItem(const QString &spriteRoot,
                         int tileSize,
                         QGraphicsItem *parent = nullptr);
+    explicit PlayerItem(const PlayerSprites &sprites,
+                        QGraphicsItem *parent = nullptr);
+
+    // Frames only advance while the item is on a clock
+    void setClock(AnimationClock *clock);
 
     void setDirection(Direction dir);
     void setAction(Action act);
@@ -25,8 +75,12 @@ public:
     Direction direction() const { return m_direction; }
     Action    action()    const { return m_action;    }
 
-private slots:
-    void nextFrame();
+    // Frame on show: slot() of its animation and index within it
+    int animationSlot() const { return m_slot; }
+    int frameIndex()    const { return m_frameIndex; }
+
+    bool   advanceAnimation(qint64 nowNs) override;
+    QRectF animationBounds() const override { return sceneBoundingRect(); }
 
 private:
     struct Animation {
@@ -34,25 +88,16 @@ private:
         int fps = 8;
     };
 
-    QMap<QString, Animation> m_animations;
-    QString m_currentKey;
-    int     m_frameIndex;
-    QTimer  m_timer;
-    QString m_spriteRoot;
-
-    int m_tileSize;
-    bool m_scaleComputed = false;
-    float m_scale = 0.8f;
+    Animation       m_animations[kSlots];
+    int             m_slot       = 0;
+    int             m_frameIndex = 0;
+    qint64          m_startNs    = 0;
+    AnimationClock *m_clock      = nullptr;
 
     Direction m_direction;
     Action    m_action;
 
-    QVector<QPixmap> loadFrames(const QString &folder);
-    void addAnimation(const QString &key,
-                      const QString &folderOnDisk,
-                      int fps);
-    void setAnimation(const QString &key);
-    QString keyFor(Direction d, Action a) const;
+    void setAnimation(int index);
 };
 
 #endif // PLAYERITEM_H
@@ -0,0 +1,164 @@
+#include "renderbench.h"
+#include "levelloader.h"
+#include "tilelayer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QRandomGenerator>
+
+#include <memory>
+
+namespace {
+
+constexpr int kCell       = 32;
+constexpr int kChunkCells = 8;
+constexpr int kFrames     = 120;
+const QSize   kView(480, 272);
+
+LevelAssets benchAssets()
+{
+    LevelAssets a;
+    a.maze = MazeGenerator(20, 30, 1).generate();
+
+    QImage wall(kCell, kCell, QImage::Format_ARGB32_Premultiplied);
+    wall.fill(QColor(90, 90, 100));
+    QImage floor(kCell, kCell, QImage::Format_ARGB32_Premultiplied);
+    floor.fill(QColor(40, 35, 30));
+    a.wallTiles  = { wall };
+    a.floorTiles = { floor };
+
+    const int rows = int(a.maze.grid.size());
+    const int cols = int(a.maze.grid[0].size());
+    a.tileVariant.fill(0, rows * cols);
+    return a;
+}
+
+// Old layout: one rect item per tile in a BSP-indexed scene
+QGraphicsScene *tileItemScene(const LevelAssets &a)
+{
+    const auto &grid = a.maze.grid;
+    const QBrush wall(QPixmap::fromImage(a.wallTiles[0]));
+    const QBrush floor(QPixmap::fromImage(a.floorTiles[0]));
+
+    auto *scene = new QGraphicsScene;
+    for (int r = 0; r < int(grid.size()); ++r) {
+        for (int c = 0; c < int(grid[r].size()); ++c) {
+            auto *tile = scene->addRect(c * kCell, r * kCell, kCell, kCell, QPen(Qt::NoPen),
+                                        grid[r][c] == 1 ? wall : floor);
+            tile->setZValue(grid[r][c] == 1 ? -1 : -2);
+        }
+    }
+    return scene;
+}
+
+// Current layout: tile chunks as the background of a NoIndex scene
+QGraphicsScene *levelScene(const LevelAssets &a)
+{
+    const int rows = int(a.maze.grid.size());
+    const int cols = int(a.maze.grid[0].size());
+
+    auto *scene = new LevelScene;
+    for (int r = 0; r < rows; r += kChunkCells) {
+        for (int c = 0; c < cols; c += kChunkCells) {
+            const QRect cells(c, r, qMin(kChunkCells, cols - c), qMin(kChunkCells, rows - r));
+            scene->addTileChunk(QPoint(c * kCell, r * kCell),
+                                QPixmap::fromImage(renderTileChunk(a, cells, kCell)));
+        }
+    }
+    return scene;
+}
+
+RenderBenchRow measure(const LevelAssets &a, bool chunks, int monsters)
+{
+    std::unique_ptr<QGraphicsScene> level(chunks ? levelScene(a) : tileItemScene(a));
+    QGraphicsScene &scene = *level;
+    scene.setSceneRect(0, 0, int(a.maze.grid[0].size()) * kCell,
+                       int(a.maze.grid.size()) * kCell);
+
+    QVector<QPointF> passages;
+    const auto &grid = a.maze.grid;
+    for (int r = 0; r < int(grid.size()); ++r)
+        for (int c = 0; c < int(grid[r].size()); ++c)
+            if (grid[r][c] == 0)
+                passages.append(QPointF(c * kCell, r * kCell));
+
+    QPixmap sprite(kCell, kCell);
+    sprite.fill(Qt::red);
+
+    QRandomGenerator rng(7);
+    QVector<QGraphicsPixmapItem*> items;
+    for (int i = 0; i < monsters; ++i) {
+        QGraphicsPixmapItem *item = scene.addPixmap(sprite);
+        item->setPos(passages[rng.bounded(passages.size())]);
+        items.append(item);
+    }
+
+    // Painted through a view set up like GameView's, so the current layout
+    // goes through the cached background and its scrolling
+    QGraphicsView view(&scene);
+    view.setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    view.setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    view.setFrameShape(QFrame::NoFrame);
+    if (chunks) {
+        view.setCacheMode(QGraphicsView::CacheBackground);
+        view.setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+        view.setOptimizationFlags(QGraphicsView::DontSavePainterState |
+                                  QGraphicsView::DontAdjustForAntialiasing);
+    }
+    view.setFixedSize(kView);
+    view.setAttribute(Qt::WA_DontShowOnScreen);
+    view.show();
+
+    // Settle the initial index build and the first paint outside the timings
+    scene.items(scene.sceneRect());
+    view.viewport()->grab();
+
+    RenderBenchRow row { chunks ? "background+noindex" : "tiles+bsp", monsters, 0, 0, 0 };
+    QElapsedTimer t;
+
+    for (int frame = 0; frame < kFrames; ++frame) {
+        t.start();
+        for (QGraphicsPixmapItem *item : items)
+            item->moveBy(rng.bounded(5) - 2, rng.bounded(5) - 2);
+        row.moveMs += t.nsecsElapsed() / 1e6;
+
+        // Camera sweeps across the maze in whole pixels, like GameView's
+        const QRectF bounds = scene.sceneRect();
+        const qreal f = qreal(frame) / kFrames;
+        const QRectF visible(qRound(bounds.left() + f * (bounds.width() - kView.width())),
+                             qRound(bounds.top() + f * (bounds.height() - kView.height())),
+                             kView.width(), kView.height());
+
+        t.start();
+        scene.items(visible);
+        row.queryMs += t.nsecsElapsed() / 1e6;
+
+        t.start();
+        view.centerOn(visible.center());
+        QCoreApplication::processEvents();   // queued scene updates
+        view.viewport()->grab();
+        row.paintMs += t.nsecsElapsed() / 1e6;
+    }
+    row.moveMs  /= kFrames;
+    row.queryMs /= kFrames;
+    row.paintMs /= kFrames;
+    return row;
+}
+
+} // namespace
+
+QVector<RenderBenchRow> runRenderBench()
+{
+    const LevelAssets assets = benchAssets();
+
+    QVector<RenderBenchRow> rows;
+    for (int monsters : { 0, 25, 50, 100, 200, 400 }) {
+        rows.append(measure(assets, false, monsters));
+        rows.append(measure(assets, true, monsters));
+    }
+    return rows;
+}
@@ -0,0 +1,22 @@
+#ifndef RENDERBENCH_H
+#define RENDERBENCH_H
+
+#include <QVector>
+
+// Scene cost per frame as the monster count grows, for the two ways of
+// holding the static maze: one item per tile in a BSP-indexed scene (the
+// old layout) and pre-rendered tile chunks drawn as the background of a
+// NoIndex scene (LevelScene). Needs a
+// QApplication for pixmaps; runs fine with -platform offscreen.
+struct RenderBenchRow
+{
+    const char *layout;
+    int         monsters;
+    double      moveMs;    // moving every monster
+    double      queryMs;   // items() over the view, incl. pending index work
+    double      paintMs;   // scrolling a 480x272 view, grabbing its viewport
+};
+
+QVector<RenderBenchRow> runRenderBench();
+
+#endif // RENDERBENCH_H
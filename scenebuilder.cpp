@@ -0,0 +1,42 @@
+#include "scenebuilder.h"
+#include "frameprofiler.h"
+
+#include <QElapsedTimer>
+
+SceneBuilder::SceneBuilder(QObject *parent)
+    : QObject(parent)
+{
+    // Zero interval: one slice per pass through the event loop
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &SceneBuilder::runSlice);
+}
+
+void SceneBuilder::add(std::function<void()> job)
+{
+    m_jobs.enqueue(std::move(job));
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void SceneBuilder::clear()
+{
+    m_jobs.clear();
+    m_timer.stop();
+}
+
+void SceneBuilder::runSlice()
+{
+    PROFILE_SCOPE("sceneSlice");
+
+    QElapsedTimer t;
+    t.start();
+
+    do {
+        // A job may clear() the queue (e.g. when it starts the next level)
+        std::function<void()> job = m_jobs.dequeue();
+        job();
+    } while (!m_jobs.isEmpty() && t.nsecsElapsed() < m_budgetNs);
+
+    if (m_jobs.isEmpty())
+        m_timer.stop();
+}
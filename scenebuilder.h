@@ -0,0 +1,40 @@
+#ifndef SCENEBUILDER_H
+#define SCENEBUILDER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+
+#include <functional>
+
+// Runs queued jobs on the GUI thread in time-bounded slices, one slice per
+// event-loop turn, so building a large scene never blocks input, painting
+// or the loading animation for longer than the budget.
+class SceneBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SceneBuilder(QObject *parent = nullptr);
+
+    // Time per slice; at least one job always runs
+    void setBudgetMs(double ms) { m_budgetNs = qint64(ms * 1e6); }
+
+    // Jobs run in the order added
+    void add(std::function<void()> job);
+
+    // Drop every job that has not run yet
+    void clear();
+
+    int pending() const { return m_jobs.size(); }
+
+private slots:
+    void runSlice();
+
+private:
+    QQueue<std::function<void()>> m_jobs;
+    QTimer                        m_timer;
+    qint64                        m_budgetNs = 4000000;   // 4 ms
+};
+
+#endif // SCENEBUILDER_H
@@ -0,0 +1,221 @@
+#include "softrenderer.h"
+#include "levelloader.h"
+#include "frameprofiler.h"
+
+#include <QPainter>
+
+#include <cstring>
+
+namespace {
+
+constexpr int kAtlasWidth = 1024;
+
+// Source pixels are premultiplied ARGB32; destinations XRGB8888 or RGB565
+inline void blendPixel(quint32 s, quint32 *d)
+{
+    const quint32 a = qAlpha(s);
+    if (a == 255) {
+        *d = s;
+        return;
+    }
+    const quint32 ia = 255 - a;
+    *d = qRgb(qRed(s)   + qRed(*d)   * ia / 255,
+              qGreen(s) + qGreen(*d) * ia / 255,
+              qBlue(s)  + qBlue(*d)  * ia / 255);
+}
+
+inline quint16 pack565(quint32 r, quint32 g, quint32 b)
+{
+    return quint16(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+inline void blendPixel(quint32 s, quint16 *d)
+{
+    const quint32 a = qAlpha(s);
+    if (a == 255) {
+        *d = pack565(qRed(s), qGreen(s), qBlue(s));
+        return;
+    }
+    const quint32 r5 = *d >> 11, g6 = (*d >> 5) & 0x3f, b5 = *d & 0x1f;
+    const quint32 ia = 255 - a;
+    *d = pack565(qRed(s)   + ((r5 << 3) | (r5 >> 2)) * ia / 255,
+                 qGreen(s) + ((g6 << 2) | (g6 >> 4)) * ia / 255,
+                 qBlue(s)  + ((b5 << 3) | (b5 >> 2)) * ia / 255);
+}
+
+inline void packColor(QRgb c, quint32 *p) { *p = 0xff000000u | c; }
+inline void packColor(QRgb c, quint16 *p) { *p = pack565(qRed(c), qGreen(c), qBlue(c)); }
+
+template <typename Pixel>
+void fillRect(QImage &frame, const QRect &rect, QRgb color)
+{
+    const QRect r = rect & frame.rect();
+    if (r.isEmpty())
+        return;
+
+    Pixel value;
+    packColor(color, &value);
+    for (int y = r.top(); y <= r.bottom(); ++y) {
+        Pixel *d = reinterpret_cast<Pixel *>(frame.scanLine(y)) + r.left();
+        for (int x = 0; x < r.width(); ++x)
+            d[x] = value;
+    }
+}
+
+} // namespace
+
+void SoftRenderer::setTarget(const QSize &size, QImage::Format format)
+{
+    Q_ASSERT(format == QImage::Format_RGB16 || format == QImage::Format_RGB32);
+    m_frame = QImage(size, format);
+    m_frame.fill(Qt::black);
+}
+
+void SoftRenderer::setLevel(const LevelAssets &assets, int cellSize)
+{
+    const auto &grid = assets.maze.grid;
+    m_cellSize = cellSize;
+    m_rows = int(grid.size());
+    m_cols = m_rows ? int(grid[0].size()) : 0;
+
+    // Walls first, then floors, flattened onto black in the frame format
+    const int walls  = assets.wallTiles.size();
+    const int floors = assets.floorTiles.size();
+    m_tiles = QImage(cellSize, cellSize * qMax(1, walls + floors), m_frame.format());
+    m_tiles.fill(Qt::black);
+    {
+        QPainter p(&m_tiles);
+        for (int i = 0; i < walls; ++i)
+            p.drawImage(QRect(0, i * cellSize, cellSize, cellSize), assets.wallTiles[i]);
+        for (int i = 0; i < floors; ++i)
+            p.drawImage(QRect(0, (walls + i) * cellSize, cellSize, cellSize),
+                        assets.floorTiles[i]);
+    }
+
+    m_cellTile.fill(-1, m_rows * m_cols);
+    for (int r = 0; r < m_rows; ++r) {
+        for (int c = 0; c < m_cols; ++c) {
+            const int variant = assets.tileVariant.value(r * m_cols + c, -1);
+            if (variant >= 0)
+                m_cellTile[r * m_cols + c] = (grid[r][c] == 1) ? variant : walls + variant;
+        }
+    }
+}
+
+void SoftRenderer::setSprites(const QVector<QImage> &images)
+{
+    // Shelves left to right, a new one when a row is full
+    m_spriteRects.resize(images.size());
+    int x = 0, y = 0, shelf = 0;
+    for (int i = 0; i < images.size(); ++i) {
+        const QSize s = images[i].size();
+        if (x > 0 && x + s.width() > kAtlasWidth) {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        m_spriteRects[i] = QRect(QPoint(x, y), s);
+        x += s.width();
+        shelf = qMax(shelf, s.height());
+    }
+
+    m_sprites = QImage(kAtlasWidth, qMax(1, y + shelf), QImage::Format_ARGB32_Premultiplied);
+    m_sprites.fill(Qt::transparent);
+
+    QPainter p(&m_sprites);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int i = 0; i < images.size(); ++i) {
+        if (!images[i].isNull())
+            p.drawImage(m_spriteRects[i].topLeft(), images[i]);
+    }
+}
+
+QSize SoftRenderer::spriteSize(int sprite) const
+{
+    return (sprite >= 0 && sprite < m_spriteRects.size()) ? m_spriteRects[sprite].size()
+                                                          : QSize();
+}
+
+void SoftRenderer::render(const QPoint &camera, const std::vector<Entity> &entities,
+                          const std::vector<Bar> &bars)
+{
+    PROFILE_SCOPE("softRender");
+
+    if (m_frame.format() == QImage::Format_RGB16)
+        renderFrame<quint16>(camera, entities, bars);
+    else
+        renderFrame<quint32>(camera, entities, bars);
+}
+
+template <typename Pixel>
+void SoftRenderer::renderFrame(const QPoint &camera, const std::vector<Entity> &entities,
+                               const std::vector<Bar> &bars)
+{
+    const QRect view(camera, m_frame.size());
+
+    // Tiles: straight row copies, black where there is none
+    m_frame.fill(Qt::black);
+    if (m_cellSize > 0) {
+        const int c0 = qMax(0, view.left() / m_cellSize);
+        const int r0 = qMax(0, view.top()  / m_cellSize);
+        const int c1 = qMin(m_cols - 1, view.right()  / m_cellSize);
+        const int r1 = qMin(m_rows - 1, view.bottom() / m_cellSize);
+
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const int tile = m_cellTile[r * m_cols + c];
+                if (tile < 0 || (m_visible && !m_visible->testBit(r * m_cols + c)))
+                    continue;
+
+                const QRect cell(c * m_cellSize, r * m_cellSize, m_cellSize, m_cellSize);
+                const QRect part = cell & view;
+                const int sx = part.left() - cell.left();
+                const int sy = tile * m_cellSize + part.top() - cell.top();
+                const std::size_t bytes = std::size_t(part.width()) * sizeof(Pixel);
+
+                for (int y = 0; y < part.height(); ++y) {
+                    const Pixel *s = reinterpret_cast<const Pixel *>(
+                                         m_tiles.constScanLine(sy + y)) + sx;
+                    Pixel *d = reinterpret_cast<Pixel *>(
+                                   m_frame.scanLine(part.top() - view.top() + y))
+                               + part.left() - view.left();
+                    std::memcpy(d, s, bytes);
+                }
+            }
+        }
+    }
+
+    // Sprites in the given order, blended where not fully transparent
+    for (const Entity &e : entities) {
+        if (e.sprite < 0 || e.sprite >= m_spriteRects.size())
+            continue;
+
+        const QRect src = m_spriteRects[e.sprite];
+        const QRect part = QRect(e.pos, src.size()) & view;
+        if (part.isEmpty())
+            continue;
+
+        const int sx = src.left() + part.left() - e.pos.x();
+        const int sy = src.top()  + part.top()  - e.pos.y();
+        for (int y = 0; y < part.height(); ++y) {
+            const quint32 *s = reinterpret_cast<const quint32 *>(
+                                   m_sprites.constScanLine(sy + y)) + sx;
+            Pixel *d = reinterpret_cast<Pixel *>(
+                           m_frame.scanLine(part.top() - view.top() + y))
+                       + part.left() - view.left();
+            for (int x = 0; x < part.width(); ++x) {
+                if (qAlpha(s[x]))
+                    blendPixel(s[x], d + x);
+            }
+        }
+    }
+
+    // HUD bars on top
+    for (const Bar &bar : bars) {
+        const QRect r = bar.rect.translated(-camera);
+        fillRect<Pixel>(m_frame, r, qRgb(255, 0, 0));
+        fillRect<Pixel>(m_frame, QRect(r.topLeft(), QSize(qRound(r.width() * bar.ratio),
+                                                        r.height())),
+                        qRgb(0, 255, 0));
+    }
+}
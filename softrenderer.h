@@ -0,0 +1,70 @@
+#ifndef SOFTRENDERER_H
+#define SOFTRENDERER_H
+
+#include <QBitArray>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+#include <vector>
+
+struct LevelAssets;
+
+// Renders a frame straight into one pre-allocated image, without a scene:
+// tiles are copied row by row from a tile atlas in the frame's own pixel
+// format, sprites are blended from a premultiplied sprite atlas, HUD bars
+// are solid fills. Everything is converted when a level is set, so a frame
+// allocates nothing. Used by GameView with --renderer soft or --fb.
+class SoftRenderer
+{
+public:
+    // One sprite in draw order; `pos` is its top-left in level pixels
+    struct Entity {
+        int    sprite;
+        QPoint pos;
+    };
+
+    struct Bar {
+        QRect rect;    // level pixels
+        qreal ratio;   // filled part, 0..1
+    };
+
+    // Format_RGB16 (RGB565) or Format_RGB32 (XRGB8888)
+    void setTarget(const QSize &size, QImage::Format format);
+    const QImage &frame() const { return m_frame; }
+
+    // Tile grid and tile images of a level
+    void setLevel(const LevelAssets &assets, int cellSize);
+
+    // One bit per grid cell (row-major); tiles of cells without it are
+    // left black. Null draws every tile.
+    void setVisibleCells(const QBitArray *visible) { m_visible = visible; }
+
+    // Packs the images into the sprite atlas; ids are their indices
+    void setSprites(const QVector<QImage> &images);
+    QSize spriteSize(int sprite) const;
+
+    // `camera` is the frame's top-left in level pixels
+    void render(const QPoint &camera, const std::vector<Entity> &entities,
+                const std::vector<Bar> &bars);
+
+private:
+    template <typename Pixel>
+    void renderFrame(const QPoint &camera, const std::vector<Entity> &entities,
+                     const std::vector<Bar> &bars);
+
+    QImage m_frame;
+
+    int          m_cellSize = 0;
+    int          m_rows = 0;
+    int          m_cols = 0;
+    QVector<int> m_cellTile;   // tile atlas slot per cell, -1 = none
+    QImage       m_tiles;      // one column of cellSize squares, frame format
+    const QBitArray *m_visible = nullptr;
+
+    QImage         m_sprites;  // premultiplied ARGB, shelf packed
+    QVector<QRect> m_spriteRects;
+};
+
+#endif // SOFTRENDERER_H
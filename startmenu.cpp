@@ -1,5 +1,6 @@
 #include "startmenu.h"
 #include "gameview.h"
+#include "assetcache.h"
 
 #include <QPushButton>
 #include <QLabel>
@@ -7,11 +8,17 @@
 #include <QFont>
 #include <QInputDialog>
 
-StartMenu::StartMenu(QWidget *parent)
+static QStringList characterNames()
+{
+    return QStringList() << "Assassin" << "Robber" << "Thug";
+}
+
+StartMenu::StartMenu(const LaunchOptions &options, QWidget *parent)
     : QWidget(parent),
     m_startButton(new QPushButton("Start Game", this)),
     m_quitButton(new QPushButton("Quit", this)),
-    m_titleLabel(new QLabel("Maze Game", this))
+    m_titleLabel(new QLabel("Maze Game", this)),
+    m_options(options)
 {
     // Title label styling
     QFont titleFont;
@@ -39,11 +46,25 @@ StartMenu::StartMenu(QWidget *parent)
             this, &StartMenu::onQuitClicked);
 }
 
+void StartMenu::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    // Decode whatever the first level may need while the player is still
+    // in the menu; the level loader then finds it all in the cache. The
+    // list itself is built on the pool: it reads folders and image headers
+    if (!m_warmedUp) {
+        m_warmedUp = true;
+        AssetCache::instance().preload([] {
+            return GameView::warmUpRequests(characterNames());
+        });
+    }
+}
+
 void StartMenu::onStartClicked()
 {
     // Let the player choose a character
-    QStringList characters;
-    characters << "Assassin" << "Robber" << "Thug";
+    const QStringList characters = characterNames();
 
     bool ok = false;
     QString chosen = QInputDialog::getItem(
@@ -62,7 +83,7 @@ void StartMenu::onStartClicked()
     }
 
     // Create and show the game window with the chosen character
-    GameView *view = new GameView(chosen);
+    GameView *view = new GameView(chosen, m_options);
     view->setAttribute(Qt::WA_DeleteOnClose);
     view->show();
 
@@ -3,15 +3,22 @@
 
 #include <QWidget>
 
+#include "launchoptions.h"
+
 class QPushButton;
 class QLabel;
+class QShowEvent;
 
 class StartMenu : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit StartMenu(QWidget *parent = nullptr);
+    explicit StartMenu(const LaunchOptions &options = LaunchOptions(),
+                       QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
 
 private slots:
     void onStartClicked();
@@ -21,6 +28,9 @@ private:
     QPushButton *m_startButton;
     QPushButton *m_quitButton;
     QLabel *m_titleLabel;
+
+    LaunchOptions m_options;   // handed on to the game
+    bool          m_warmedUp = false;
 };
 
 #endif // STARTMENU_H
@@ -1,5 +1,4 @@
 #include "textures.h"
-#include <QRandomGenerator>
 
 QVector<TextureFamily> wallFamilies()
 {
@@ -58,45 +57,21 @@ QVector<TextureFamily> floorFamilies()
     };
 }
 
-TextureSet loadRandomTextureSet(const QVector<TextureFamily> &families,
-                                int cellSize,
-                                const QString &basePath)
+QString textureFilePath(const QString &basePath, const TextureFamily &family, int index)
 {
-    TextureSet set;
-
-    if (families.isEmpty())
-        return set;
-
-    int idx = QRandomGenerator::global()->bounded(families.size());
-    const TextureFamily &chosen = families[idx];
-    set.prefix = chosen.prefix;
-
-    for (int i = 0; i < chosen.count; ++i) {
-        // If you are using Qt resources (.qrc), basePath should be like
-        // ":/texture/walls/" or ":/texture/floor/"
-        QString fileName = QString("%1%2%3.png")
-                               .arg(basePath)
-                               .arg(chosen.prefix)
-                               .arg(i);
-
-        QPixmap tex(fileName);
-        if (tex.isNull())
-            continue;
-
-        tex = tex.scaled(cellSize, cellSize,
-                         Qt::IgnoreAspectRatio,
-                         Qt::SmoothTransformation);
-        set.pixmaps.push_back(tex);
-        set.brushes.push_back(QBrush(set.pixmaps.back()));
-    }
-
-    return set;
+    // If you are using Qt resources (.qrc), basePath should be like
+    // ":/texture/walls/" or ":/texture/floor/"
+    return QString("%1%2%3.png")
+        .arg(basePath)
+        .arg(family.prefix)
+        .arg(index);
 }
 
-QBrush TextureSet::randomBrush() const
+AssetRequest textureRequest(const QString &path, int cellSize)
 {
-    if (brushes.isEmpty())
-        return QBrush();
-    int idx = QRandomGenerator::global()->bounded(brushes.size());
-    return brushes[idx];
+    AssetRequest req;
+    req.path = path;
+    req.size = QSize(cellSize, cellSize);
+    req.mode = Qt::IgnoreAspectRatio;
+    return req;
 }
@@ -3,8 +3,9 @@
 
 #include <QVector>
 #include <QString>
-#include <QPixmap>
-#include <QBrush>
+#include <QImage>
+
+#include "assetcache.h"
 
 struct TextureFamily
 {
@@ -12,22 +13,14 @@ struct TextureFamily
     int     count;    // how many numbered tiles (0..count-1)
 };
 
-struct TextureSet
-{
-    QString          prefix;
-    QVector<QPixmap> pixmaps;
-    QVector<QBrush>  brushes;
-
-    QBrush randomBrush() const;
-};
-
 // Lists of available families
 QVector<TextureFamily> wallFamilies();
 QVector<TextureFamily> floorFamilies();
 
-// Pick a random family from list & load all its textures
-TextureSet loadRandomTextureSet(const QVector<TextureFamily> &families,
-                                int cellSize,
-                                const QString &basePath);
+// File of tile `index` of a family, e.g. <basePath>brick_brown3.png
+QString textureFilePath(const QString &basePath, const TextureFamily &family, int index);
+
+// One tile scaled to the cell size, for AssetCache
+AssetRequest textureRequest(const QString &path, int cellSize);
 
 #endif // TEXTURES_H
@@ -0,0 +1,109 @@
+#include "tilelayer.h"
+#include "levelloader.h"
+#include "fieldofview.h"
+
+#include <QPainter>
+
+LevelScene::LevelScene(QObject *parent)
+    : QGraphicsScene(parent)
+{
+    setItemIndexMethod(QGraphicsScene::NoIndex);
+}
+
+void LevelScene::addTileChunk(const QPoint &pos, const QPixmap &pixmap)
+{
+    m_chunks.append({ QRect(pos, pixmap.size()), pixmap });
+
+    // Views re-render their cached background under the new chunk only
+    invalidate(QRectF(m_chunks.last().rect), QGraphicsScene::BackgroundLayer);
+}
+
+void LevelScene::removeTileChunk(const QPoint &pos)
+{
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        if (m_chunks[i].rect.topLeft() != pos)
+            continue;
+        invalidate(QRectF(m_chunks[i].rect), QGraphicsScene::BackgroundLayer);
+        m_chunks.remove(i);
+        return;
+    }
+}
+
+void LevelScene::setFieldOfView(const FieldOfView *fov, int cellSize)
+{
+    m_fov      = fov;
+    m_cellSize = cellSize;
+    invalidate(sceneRect(), QGraphicsScene::BackgroundLayer);
+}
+
+void LevelScene::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsScene::drawBackground(painter, rect);
+
+    // Unseen cells are dark, as in the soft renderer, not the palette's base
+    if (m_fov)
+        painter->fillRect(rect, Qt::black);
+
+    for (const Chunk &chunk : m_chunks) {
+        if (!rect.intersects(chunk.rect))
+            continue;
+        if (m_fov)
+            drawVisibleCells(painter, chunk, rect);
+        else
+            painter->drawPixmap(chunk.rect.topLeft(), chunk.pixmap);
+    }
+}
+
+void LevelScene::drawVisibleCells(QPainter *painter, const Chunk &chunk, const QRectF &rect)
+{
+    // Cells of the chunk inside both the exposed rect and the field of view
+    const QRect cells = QRect(chunk.rect.left() / m_cellSize, chunk.rect.top() / m_cellSize,
+                              chunk.rect.width() / m_cellSize, chunk.rect.height() / m_cellSize)
+                        & m_fov->bounds()
+                        & QRect(int(rect.left()) / m_cellSize, int(rect.top()) / m_cellSize,
+                                int(rect.width()) / m_cellSize + 2,
+                                int(rect.height()) / m_cellSize + 2);
+
+    // One blit per run of visible cells in a row
+    for (int r = cells.top(); r <= cells.bottom(); ++r) {
+        int c = cells.left();
+        while (c <= cells.right()) {
+            if (!m_fov->isVisible(r, c)) {
+                ++c;
+                continue;
+            }
+            const int first = c;
+            while (c <= cells.right() && m_fov->isVisible(r, c))
+                ++c;
+
+            const QRect target(first * m_cellSize, r * m_cellSize,
+                               (c - first) * m_cellSize, m_cellSize);
+            painter->drawPixmap(target, chunk.pixmap, target.translated(-chunk.rect.topLeft()));
+        }
+    }
+}
+
+QImage renderTileChunk(const LevelAssets &assets, const QRect &cells, int cellSize)
+{
+    const auto &grid = assets.maze.grid;
+    const int gridCols = static_cast<int>(grid[0].size());
+
+    QImage image(cells.width() * cellSize, cells.height() * cellSize,
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter p(&image);
+    for (int r = cells.top(); r <= cells.bottom(); ++r) {
+        for (int c = cells.left(); c <= cells.right(); ++c) {
+            const int variant = assets.tileVariant[r * gridCols + c];
+            if (variant < 0)
+                continue;
+
+            const QVector<QImage> &tiles = (grid[r][c] == 1) ? assets.wallTiles
+                                                             : assets.floorTiles;
+            p.drawImage((c - cells.left()) * cellSize, (r - cells.top()) * cellSize,
+                        tiles[variant]);
+        }
+    }
+    return image;
+}
@@ -0,0 +1,67 @@
+#ifndef TILELAYER_H
+#define TILELAYER_H
+
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPixmap>
+#include <QRect>
+#include <QVector>
+
+#include <memory>
+
+struct LevelAssets;
+class FieldOfView;
+
+// Scene of one level. The static maze is its background, drawn from
+// pre-rendered chunks of tiles, so a view can cache it and scroll it; the
+// items are only what moves or changes, kept without an index since they
+// are few and most of them move every tick.
+class LevelScene : public QGraphicsScene
+{
+public:
+    explicit LevelScene(QObject *parent = nullptr);
+
+    // `pos` is the chunk's top-left in scene coordinates
+    void addTileChunk(const QPoint &pos, const QPixmap &pixmap);
+    void removeTileChunk(const QPoint &pos);
+    int  tileChunkCount() const { return m_chunks.size(); }
+
+    // Only cells the field of view sees are drawn; null draws everything.
+    // Callers invalidate the background where the view changed.
+    void setFieldOfView(const FieldOfView *fov, int cellSize);
+
+protected:
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    struct Chunk {
+        QRect   rect;
+        QPixmap pixmap;
+    };
+    QVector<Chunk> m_chunks;
+
+    const FieldOfView *m_fov = nullptr;
+    int                m_cellSize = 0;
+
+    void drawVisibleCells(QPainter *painter, const Chunk &chunk, const QRectF &rect);
+};
+
+// Tiles of `cells` (grid coordinates) in one image, cells without a
+// texture left transparent. Uses the level's decoded tile images only.
+QImage renderTileChunk(const LevelAssets &assets, const QRect &cells, int cellSize);
+
+// renderTileChunk as a QtConcurrent::mapped function over chunk rects
+struct TileChunkRasterizer
+{
+    using result_type = QImage;
+
+    std::shared_ptr<const LevelAssets> assets;
+    int                                cellSize;
+
+    QImage operator()(const QRect &cells) const
+    {
+        return renderTileChunk(*assets, cells, cellSize);
+    }
+};
+
+#endif // TILELAYER_H
@@ -0,0 +1,178 @@
+#include "worldstreamer.h"
+#include "frameprofiler.h"
+#include "levelloader.h"
+#include "mazegenerator.h"
+#include "tilelayer.h"
+
+#include <QFutureWatcher>
+#include <QRandomGenerator>
+#include <QtConcurrent>
+
+WorldStreamer::WorldStreamer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+// Chunks still in flight finish on the pool with their own copies
+WorldStreamer::~WorldStreamer() = default;
+
+quint64 WorldStreamer::key(const QPoint &chunk)
+{
+    return (quint64(quint32(chunk.x())) << 32) | quint32(chunk.y());
+}
+
+QPoint WorldStreamer::chunkOf(int row, int col)
+{
+    auto floorDiv = [](int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+    return QPoint(floorDiv(col, kChunkCells), floorDiv(row, kChunkCells));
+}
+
+void WorldStreamer::reset(const LevelAssets &tiles, quint32 seed, int cellSize)
+{
+    // Only the tile images go along to the workers
+    auto t = std::make_shared<LevelAssets>();
+    t->wallTiles  = tiles.wallTiles;
+    t->floorTiles = tiles.floorTiles;
+    m_tiles = t;
+
+    m_seed     = seed;
+    m_cellSize = cellSize;
+    ++m_generation;
+
+    m_chunks.clear();
+    m_lru.clear();
+    m_pending.clear();
+    m_bytes = 0;
+}
+
+void WorldStreamer::setFocus(const QPoint &chunk)
+{
+    m_focus = chunk;
+
+    for (int dy = -kKeepRadius; dy <= kKeepRadius; ++dy) {
+        for (int dx = -kKeepRadius; dx <= kKeepRadius; ++dx) {
+            const QPoint c = chunk + QPoint(dx, dy);
+            if (m_chunks.contains(key(c)))
+                touch(c);
+            else if (!m_pending.contains(key(c)))
+                request(c);
+        }
+    }
+
+    // Chunks left behind may go now
+    evict();
+}
+
+bool WorldStreamer::isFocusReady() const
+{
+    for (int dy = -kKeepRadius; dy <= kKeepRadius; ++dy) {
+        for (int dx = -kKeepRadius; dx <= kKeepRadius; ++dx) {
+            if (!m_chunks.contains(key(m_focus + QPoint(dx, dy))))
+                return false;
+        }
+    }
+    return true;
+}
+
+int WorldStreamer::cell(int row, int col) const
+{
+    const QPoint chunk = chunkOf(row, col);
+    auto it = m_chunks.constFind(key(chunk));
+    if (it == m_chunks.constEnd())
+        return 1;
+
+    const int r = row - chunk.y() * kChunkCells;
+    const int c = col - chunk.x() * kChunkCells;
+    return it->cells[r * kChunkCells + c];
+}
+
+QImage WorldStreamer::takeImage(const QPoint &chunk)
+{
+    auto it = m_chunks.find(key(chunk));
+    if (it == m_chunks.end())
+        return QImage();
+
+    QImage image = it->image;
+    it->image = QImage();
+    return image;
+}
+
+WorldStreamer::Chunk WorldStreamer::build(std::shared_ptr<const LevelAssets> tiles,
+                                          quint32 seed, int cellSize, const QPoint &chunk)
+{
+    PROFILE_SCOPE("worldChunk");
+
+    LevelAssets a;
+    a.maze       = MazeGenerator::generateChunk(chunk.x(), chunk.y(), kChunkSize, seed);
+    a.wallTiles  = tiles->wallTiles;
+    a.floorTiles = tiles->floorTiles;
+
+    const auto &grid = a.maze.grid;
+    const int n = kChunkCells;
+
+    // Tile choice per cell, as the level loader bakes it
+    Chunk out;
+    out.cells.resize(n * n);
+    a.tileVariant.resize(n * n);
+    QRandomGenerator rng(a.maze.seed);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            const int count = (grid[r][c] == 1) ? a.wallTiles.size() : a.floorTiles.size();
+            a.tileVariant[r * n + c] = count ? qint8(rng.bounded(count)) : qint8(-1);
+            out.cells[r * n + c] = quint8(grid[r][c]);
+        }
+    }
+
+    out.image = renderTileChunk(a, QRect(0, 0, n, n), cellSize);
+    out.bytes = out.cells.size() + out.image.sizeInBytes();
+    return out;
+}
+
+void WorldStreamer::request(const QPoint &chunk)
+{
+    const int generation = m_generation;
+    m_pending.insert(key(chunk), generation);
+
+    auto *watcher = new QFutureWatcher<Chunk>(this);
+    connect(watcher, &QFutureWatcher<Chunk>::finished, this, [this, watcher, chunk, generation] {
+        watcher->deleteLater();
+        if (generation != m_generation)
+            return;
+
+        m_pending.remove(key(chunk));
+        const Chunk built = watcher->result();
+        m_chunks.insert(key(chunk), built);
+        m_bytes += built.bytes;
+
+        // A chunk the focus has already left is the first to go
+        const QPoint d = chunk - m_focus;
+        if (qAbs(d.x()) <= kKeepRadius && qAbs(d.y()) <= kKeepRadius)
+            m_lru.prepend(chunk);
+        else
+            m_lru.append(chunk);
+
+        emit chunkReady(chunk);
+        evict();
+    });
+    watcher->setFuture(QtConcurrent::run(build, m_tiles, m_seed, m_cellSize, chunk));
+}
+
+void WorldStreamer::touch(const QPoint &chunk)
+{
+    m_lru.removeOne(chunk);
+    m_lru.prepend(chunk);
+}
+
+void WorldStreamer::evict()
+{
+    for (int i = m_lru.size() - 1; i >= 0 && m_bytes > m_budget; --i) {
+        const QPoint chunk = m_lru[i];
+        const QPoint d = chunk - m_focus;
+        if (qAbs(d.x()) <= kKeepRadius && qAbs(d.y()) <= kKeepRadius)
+            continue;
+
+        m_bytes -= m_chunks.take(key(chunk)).bytes;
+        m_lru.removeAt(i);
+        emit chunkEvicted(chunk);
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef WORLDSTREAMER_H
+#define WORLDSTREAMER_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPoint>
+#include <QVector>
+
+#include <memory>
+
+struct LevelAssets;
+
+// Open-world maze, streamed in square chunks around a focus chunk. Missing
+// chunks are generated (MazeGenerator::generateChunk) and their tiles
+// rendered on the thread pool; resident chunks are evicted least recently
+// used once they take more than the memory budget, except the ones around
+// the focus. Memory stays flat however far the player walks.
+class WorldStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kChunkSize  = 4;                 // coarse maze cells per side
+    static constexpr int kChunkCells = 4 * kChunkSize;    // grid cells per side
+    static constexpr int kKeepRadius = 1;                 // chunks kept around the focus
+
+    explicit WorldStreamer(QObject *parent = nullptr);
+    ~WorldStreamer() override;
+
+    // Drops every chunk; tiles come from the wall/floor images of `tiles`
+    void reset(const LevelAssets &tiles, quint32 seed, int cellSize);
+    void setMemoryBudget(qint64 bytes) { m_budget = bytes; }
+
+    // Requests the chunks around `chunk` and marks them recently used
+    void   setFocus(const QPoint &chunk);
+    QPoint focus() const { return m_focus; }
+    bool   isFocusReady() const;   // every chunk within kKeepRadius resident
+
+    // Grid value of a world cell; cells of missing chunks are wall
+    int cell(int row, int col) const;
+    static QPoint chunkOf(int row, int col);
+
+    // Rendered tiles of a chunk after chunkReady, handed out once
+    QImage takeImage(const QPoint &chunk);
+
+    int    residentCount() const { return m_chunks.size(); }
+    qint64 residentBytes() const { return m_bytes; }
+
+signals:
+    void chunkReady(const QPoint &chunk);
+    void chunkEvicted(const QPoint &chunk);
+
+private:
+    struct Chunk {
+        QVector<quint8> cells;   // kChunkCells squared, row-major
+        QImage          image;
+        qint64          bytes = 0;   // cells plus tile pixels, wherever they live
+    };
+
+    static quint64 key(const QPoint &chunk);
+    static Chunk   build(std::shared_ptr<const LevelAssets> tiles, quint32 seed,
+                         int cellSize, const QPoint &chunk);
+
+    void request(const QPoint &chunk);
+    void touch(const QPoint &chunk);
+    void evict();
+
+    std::shared_ptr<const LevelAssets> m_tiles;
+    quint32 m_seed       = 0;
+    int     m_cellSize   = 32;
+    int     m_generation = 0;   // results of older generations are dropped
+
+    qint64 m_budget = 24 * 1024 * 1024;
+    qint64 m_bytes  = 0;
+    QPoint m_focus;
+
+    QHash<quint64, Chunk> m_chunks;
+    QList<QPoint>         m_lru;       // most recently used first
+    QHash<quint64, int>   m_pending;   // generation of each chunk in flight
+};
+
+#endif // WORLDSTREAMER_H